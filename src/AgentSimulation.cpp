@@ -0,0 +1,111 @@
+#include "AgentSimulation.h"
+#include "Profiler.h"
+#include <algorithm>
+
+void AgentSimulation::Reset(const DistanceField& field)
+{
+	this->field = &field;
+	positions.clear();
+	speeds.clear();
+	arrivalTicks.clear();
+	arrivedCount = 0;
+	tick = 0;
+}
+
+void AgentSimulation::AddAgent(std::uint32_t index, int speed)
+{
+	positions.push_back(index);
+	speeds.push_back(static_cast<std::uint8_t>(std::max(1, std::min(speed, maxSpeed))));
+	arrivalTicks.push_back(notArrived);
+}
+
+void AgentSimulation::Spawn(const Maze& maze, std::size_t count, RandomEngine& random)
+{
+	std::size_t cellCount = static_cast<std::size_t>(maze.GetWidth()) * maze.GetHeight();
+
+	positions.reserve(positions.size() + count);
+	speeds.reserve(speeds.size() + count);
+	arrivalTicks.reserve(arrivalTicks.size() + count);
+
+	for (std::size_t i = 0; i < count; i++)
+	{
+		std::uint32_t index;
+
+		do {
+			index = static_cast<std::uint32_t>(RandomBelow(random, cellCount));
+		} while (field->GetDistance(index) == DistanceField::unreachable);
+
+		AddAgent(index, 1 + static_cast<int>(RandomBelow(random, maxSpeed)));
+	}
+}
+
+std::size_t AgentSimulation::Tick(WorkStealingPool* pool)
+{
+	MAZE_PROFILE_SCOPE("TickAgents");
+
+	tick++;
+	std::size_t arrived = 0;
+	std::size_t taskCount = (positions.size() + agentsPerTask - 1) / agentsPerTask;
+
+	if (pool == nullptr || taskCount <= 1) {
+		arrived = TickRange(0, positions.size());
+	}
+	else
+	{
+		// Each task writes only its own agents and its own count.
+		taskArrivals.assign(taskCount, 0);
+
+		for (std::size_t task = 0; task < taskCount; task++)
+		{
+			pool->Submit([this, task](int)
+			{
+				std::size_t first = task * agentsPerTask;
+				taskArrivals[task] = TickRange(first, std::min(first + agentsPerTask, positions.size()));
+			});
+		}
+
+		pool->Wait();
+
+		for (std::size_t count : taskArrivals) {
+			arrived += count;
+		}
+	}
+
+	arrivedCount += arrived;
+	return arrived;
+}
+
+// The steps are unrolled to the maximum speed and masked by the speed
+// of each agent, so every agent runs the same instructions. Agents at
+// the exit stay there, since the exit leads to itself.
+std::size_t AgentSimulation::TickRange(std::size_t first, std::size_t end)
+{
+	const std::uint32_t* next = field->GetNextTable();
+	const std::uint32_t exit = field->GetExit();
+	const std::uint32_t currentTick = tick;
+
+	std::uint32_t* agentPositions = positions.data();
+	const std::uint8_t* agentSpeeds = speeds.data();
+	std::uint32_t* agentArrivals = arrivalTicks.data();
+	std::size_t arrived = 0;
+
+	for (std::size_t i = first; i < end; i++)
+	{
+		std::uint32_t position = agentPositions[i];
+		std::uint32_t speed = agentSpeeds[i];
+
+		for (std::uint32_t step = 0; step < maxSpeed; step++)
+		{
+			std::uint32_t moved = next[position];
+			position = (step < speed) ? moved : position;
+		}
+
+		agentPositions[i] = position;
+
+		bool arrivedNow = (position == exit) & (agentArrivals[i] == notArrived);
+		agentArrivals[i] = arrivedNow ? currentTick : agentArrivals[i];
+		arrived += arrivedNow;
+	}
+
+	return arrived;
+}
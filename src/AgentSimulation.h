@@ -0,0 +1,55 @@
+#ifndef AGENT_SIMULATION_H
+#define AGENT_SIMULATION_H
+
+#include "DistanceField.h"
+#include "Random.h"
+#include "WorkStealingPool.h"
+#include <cstdint>
+#include <vector>
+
+// A crowd of agents racing to the exit of a maze. Every tick, each
+// agent takes as many steps along the distance field as its speed.
+// Agents are stored as separate arrays per attribute, and a tick is
+// the same branch-free loop over every agent, which the compiler can
+// vectorize; large crowds can be split across a pool of threads.
+class AgentSimulation
+{
+	public:
+		static constexpr int maxSpeed = 4;
+		static constexpr std::uint32_t notArrived = 0xFFFFFFFF;
+		// Agents per task when ticking on a pool.
+		static constexpr std::size_t agentsPerTask = 1 << 14;
+
+		// The field must outlive the simulation. Removes every agent.
+		void Reset(const DistanceField& field);
+
+		void AddAgent(std::uint32_t index, int speed);
+
+		// Places agents on random open cells with random speeds.
+		void Spawn(const Maze& maze, std::size_t count, RandomEngine& random);
+
+		// Advances every agent, on the pool if one is given. Returns the
+		// number of agents that reached the exit during this tick.
+		std::size_t Tick(WorkStealingPool* pool = nullptr);
+
+		std::size_t GetAgentCount() const { return positions.size(); }
+		std::size_t GetArrivedCount() const { return arrivedCount; }
+		std::uint32_t GetTick() const { return tick; }
+
+		const std::vector<std::uint32_t>& GetPositions() const { return positions; }
+		// The tick each agent reached the exit, or notArrived.
+		const std::vector<std::uint32_t>& GetArrivalTicks() const { return arrivalTicks; }
+
+	private:
+		const DistanceField* field {nullptr};
+		std::vector<std::uint32_t> positions;
+		std::vector<std::uint8_t> speeds;
+		std::vector<std::uint32_t> arrivalTicks;
+		std::vector<std::size_t> taskArrivals;
+		std::size_t arrivedCount {0};
+		std::uint32_t tick {0};
+
+		std::size_t TickRange(std::size_t first, std::size_t end);
+};
+
+#endif
@@ -4,7 +4,8 @@ Application::Application(int width, int height) : window(sf::VideoMode(width, he
 						         sf::Style::Default, sf::ContextSettings(0, 0, 4, 3, 0)),
 							 width(width), height(height)
 {
-	window.setFramerateLimit(24);
+	// Drawing is decoupled from the simulation, which steps at its own rate.
+	window.setFramerateLimit(60);
 }
 
 bool Application::Run()
@@ -29,8 +30,27 @@ void Application::Draw(const sf::Drawable& drawable)
 	window.draw(drawable);
 }
 
+void Application::DrawOnScreen(const sf::Drawable& drawable)
+{
+	sf::View camera = window.getView();
+	window.setView(window.getDefaultView());
+	window.draw(drawable);
+	window.setView(camera);
+}
+
 void Application::Display()
 {
 	window.display();
 	window.clear(sf::Color(40, 40, 40));
 }
+
+// Centers the view of the window on the given point of the world.
+void Application::SetCamera(sf::Vector2f center)
+{
+	window.setView(sf::View(center, sf::Vector2f(static_cast<float>(width), static_cast<float>(height))));
+}
+
+void Application::SetTitle(const std::string& title)
+{
+	window.setTitle(title);
+}
@@ -3,6 +3,7 @@
 
 #include "SFML\Graphics.hpp"
 #include <functional>
+#include <string>
 
 class Application
 {
@@ -13,6 +14,10 @@ class Application
 		int GetHeight() const;
 		void Draw(const sf::Drawable& drawable);
 		void Display();
+		void SetTitle(const std::string& title);
+		void SetCamera(sf::Vector2f center);
+		// Draws in window coordinates, regardless of the camera.
+		void DrawOnScreen(const sf::Drawable& drawable);
 
 	private:
 		sf::RenderWindow window;
@@ -0,0 +1,114 @@
+#include "BatchGenerator.h"
+#include "BoundedQueue.h"
+#include "MazeGenerator.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+
+BatchStats BatchGenerator::Run(const BatchSettings& settings, const BatchSink& sink)
+{
+	using namespace std::chrono;
+	auto begin = steady_clock::now();
+
+	WorkStealingPool pool(settings.threadCount);
+	int threadCount = pool.GetThreadCount();
+
+	std::vector<MazeGenerator> generators(threadCount);
+	std::vector<MazeSolver> solvers(threadCount);
+	std::vector<MazeValidator> validators(threadCount);
+	std::vector<std::vector<std::uint64_t>> latencies(threadCount);
+	std::vector<std::uint64_t> validatedBytes(threadCount, 0);
+	std::vector<std::uint64_t> validationNanoseconds(threadCount, 0);
+	BoundedQueue<BatchResult> results(settings.queueCapacity);
+
+	std::uint64_t mazesPerTask = std::max<std::size_t>(1, settings.mazesPerTask);
+
+	for (int size : settings.sizes)
+	{
+		for (std::uint64_t first = 0; first < settings.seedCount; first += mazesPerTask)
+		{
+			std::uint64_t last = std::min(first + mazesPerTask, settings.seedCount);
+
+			pool.Submit([&, size, first, last](int worker)
+			{
+				for (std::uint64_t i = first; i < last; i++)
+				{
+					auto mazeBegin = steady_clock::now();
+
+					BatchResult result;
+					result.worker = worker;
+					result.maze = generators[worker].Create(size, size, settings.firstSeed + i);
+
+					if (settings.solve) {
+						result.maze->Solve(solvers[worker]);
+					}
+
+					if (settings.validate)
+					{
+						auto validateBegin = steady_clock::now();
+						const ValidationReport& report = validators[worker].Validate(*result.maze);
+
+						result.valid = report.IsValid();
+						result.violations = report.violations;
+						validatedBytes[worker] += report.bytes;
+						validationNanoseconds[worker] += duration_cast<nanoseconds>(steady_clock::now() - validateBegin).count();
+					}
+
+					result.nanoseconds = duration_cast<nanoseconds>(steady_clock::now() - mazeBegin).count();
+					latencies[worker].push_back(result.nanoseconds);
+
+					results.Push(std::move(result));
+				}
+			});
+		}
+	}
+
+	// The queue is closed once every task has finished, which ends
+	// the loop below after the last maze has gone to the sink.
+	std::thread closer([&]
+	{
+		pool.Wait();
+		results.Close();
+	});
+
+	BatchStats stats;
+	BatchResult result;
+
+	while (results.Pop(result))
+	{
+		stats.invalidCount += result.valid ? 0 : 1;
+		sink(result);
+		stats.mazeCount++;
+	}
+
+	closer.join();
+
+	stats.seconds = duration<double>(steady_clock::now() - begin).count();
+
+	std::vector<std::uint64_t> allLatencies;
+
+	for (int worker = 0; worker < threadCount; worker++)
+	{
+		allLatencies.insert(allLatencies.end(), latencies[worker].begin(), latencies[worker].end());
+		stats.validatedBytes += validatedBytes[worker];
+		stats.validationSeconds += validationNanoseconds[worker] * 1e-9;
+
+		double busy = pool.GetWorkerStats(worker).busyNanoseconds * 1e-9;
+		stats.utilization.push_back(stats.seconds > 0.0 ? busy / stats.seconds : 0.0);
+	}
+
+	if (!allLatencies.empty())
+	{
+		auto percentile = [&](double fraction)
+		{
+			auto nth = allLatencies.begin() + static_cast<std::size_t>(fraction * (allLatencies.size() - 1));
+			std::nth_element(allLatencies.begin(), nth, allLatencies.end());
+			return *nth;
+		};
+
+		stats.medianNanoseconds = percentile(0.5);
+		stats.p99Nanoseconds = percentile(0.99);
+	}
+
+	return stats;
+}
@@ -0,0 +1,79 @@
+#ifndef BATCH_GENERATOR_H
+#define BATCH_GENERATOR_H
+
+#include "Maze.h"
+#include "MazeValidator.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+struct BatchSettings
+{
+	// Every seed in [firstSeed, firstSeed + seedCount) is generated
+	// once for every size. Sizes must be odd.
+	std::uint64_t firstSeed {0};
+	std::uint64_t seedCount {0};
+	std::vector<int> sizes;
+	int threadCount {0};
+	bool solve {true};
+	// Checks every maze with a MazeValidator on its worker.
+	bool validate {false};
+	// The number of finished mazes that may wait for the sink before
+	// the workers are made to wait.
+	std::size_t queueCapacity {256};
+	// The number of mazes a single task generates.
+	std::size_t mazesPerTask {16};
+};
+
+struct BatchResult
+{
+	std::unique_ptr<Maze> maze;
+	std::uint64_t nanoseconds {0};
+	int worker {0};
+	// Filled in when the batch validates its mazes.
+	bool valid {true};
+	std::vector<MazeViolation> violations;
+};
+
+struct BatchStats
+{
+	std::uint64_t mazeCount {0};
+	double seconds {0.0};
+	std::uint64_t medianNanoseconds {0};
+	std::uint64_t p99Nanoseconds {0};
+	// The fraction of the run each worker spent in tasks.
+	std::vector<double> utilization;
+	std::uint64_t invalidCount {0};
+	// Grid bytes validated, and the time the workers spent on it in total.
+	std::uint64_t validatedBytes {0};
+	double validationSeconds {0.0};
+
+	double GetMazesPerSecond() const
+	{
+		return seconds > 0.0 ? mazeCount / seconds : 0.0;
+	}
+
+	// The speed of a single worker validating.
+	double GetValidationBytesPerSecond() const
+	{
+		return validationSeconds > 0.0 ? validatedBytes / validationSeconds : 0.0;
+	}
+};
+
+// Receives finished mazes, one at a time, on the thread that called Run.
+typedef std::function<void(BatchResult& result)> BatchSink;
+
+// Generates (and solves) large numbers of mazes on a work-stealing
+// thread pool. Every worker has its own MazeGenerator, MazeSolver and
+// MazeValidator, so no random engine or scratch buffer is shared
+// between threads. Each maze is validated serially on its worker,
+// since the other workers are busy with mazes of their own.
+// Finished mazes pass through a bounded queue to the sink.
+class BatchGenerator
+{
+	public:
+		BatchStats Run(const BatchSettings& settings, const BatchSink& sink);
+};
+
+#endif
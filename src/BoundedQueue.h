@@ -0,0 +1,58 @@
+#ifndef BOUNDED_QUEUE_H
+#define BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+// A queue between producer and consumer threads that holds at most
+// a fixed number of items. Push blocks while the queue is full, which
+// slows producers down to the pace of the consumer (backpressure).
+template <class T>
+class BoundedQueue
+{
+	public:
+		explicit BoundedQueue(std::size_t capacity) : capacity(capacity) { }
+
+		void Push(T item)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			notFull.wait(lock, [this] { return items.size() < capacity; });
+			items.push_back(std::move(item));
+			notEmpty.notify_one();
+		}
+
+		// Waits for an item. Returns false once the queue has been
+		// closed and every item has been taken.
+		bool Pop(T& outItem)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			notEmpty.wait(lock, [this] { return !items.empty() || closed; });
+
+			if (items.empty())
+				return false;
+
+			outItem = std::move(items.front());
+			items.pop_front();
+			notFull.notify_one();
+			return true;
+		}
+
+		// No more items will be pushed.
+		void Close()
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			closed = true;
+			notEmpty.notify_all();
+		}
+
+	private:
+		std::deque<T> items;
+		std::size_t capacity;
+		bool closed {false};
+		std::mutex mutex;
+		std::condition_variable notFull;
+		std::condition_variable notEmpty;
+};
+
+#endif
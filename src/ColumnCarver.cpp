@@ -0,0 +1,249 @@
+#include "ColumnCarver.h"
+#include "WorkStealingPool.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// The tiles are spread from bits by treating an open tile as 0.
+static_assert(static_cast<int>(TileType::Path) == 0 && static_cast<int>(TileType::Wall) == 1,
+              "Carving columns relies on the values of the tile types");
+
+static int CountTrailingZeros(std::uint64_t bits)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(bits);
+#endif
+}
+
+typedef std::array<std::array<TileType, 8>, 16> TilePatterns;
+
+// The eight tiles of four cells for every combination of four bits.
+// In a cell column, even tiles are cells and odd tiles the passages
+// below them; in a wall column, even tiles are the passages.
+static constexpr TilePatterns MakePatterns(bool cells)
+{
+	TilePatterns patterns {};
+
+	for (int bits = 0; bits < 16; bits++)
+	{
+		for (int cell = 0; cell < 4; cell++)
+		{
+			TileType passage = (bits >> cell & 1) ? TileType::Path : TileType::Wall;
+			patterns[bits][cell * 2] = cells ? TileType::Path : passage;
+			patterns[bits][cell * 2 + 1] = cells ? passage : TileType::Wall;
+		}
+	}
+
+	return patterns;
+}
+
+static constexpr TilePatterns cellPatterns = MakePatterns(true);
+static constexpr TilePatterns wallPatterns = MakePatterns(false);
+
+#if defined(__AVX2__)
+// Every byte of the spread picks the byte of the bits holding its cell
+// and tests the bit of its cell. Bytes that do not depend on a bit pick
+// zero and compare it to 0 (open) or 1 (wall).
+struct SpreadMasks
+{
+	alignas(32) std::uint8_t shuffle[32];
+	alignas(32) std::uint8_t tests[32];
+};
+
+static constexpr SpreadMasks MakeSpreadMasks(bool cells)
+{
+	SpreadMasks masks {};
+
+	for (int tile = 0; tile < 32; tile++)
+	{
+		bool passage = (tile % 2 == 1) == cells;
+		int cell = tile / 2;
+
+		masks.shuffle[tile] = passage ? static_cast<std::uint8_t>(cell / 8 % 2) : 0x80;
+		masks.tests[tile] = passage ? static_cast<std::uint8_t>(1 << (cell % 8)) : (cells ? 0 : 1);
+	}
+
+	return masks;
+}
+
+static constexpr SpreadMasks cellMasks = MakeSpreadMasks(true);
+static constexpr SpreadMasks wallMasks = MakeSpreadMasks(false);
+
+// Spreads 16 bits over 32 tiles, the same way as the patterns.
+static __m256i SpreadBits(std::uint32_t bits, const SpreadMasks& masks)
+{
+	__m256i test = _mm256_load_si256(reinterpret_cast<const __m256i*>(masks.tests));
+	__m256i spread = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(bits)),
+	                                     _mm256_load_si256(reinterpret_cast<const __m256i*>(masks.shuffle)));
+	__m256i open = _mm256_cmpeq_epi8(_mm256_and_si256(spread, test), test);
+
+	return _mm256_andnot_si256(open, _mm256_set1_epi8(1));
+}
+#endif
+
+void ColumnCarver::Carve(Matrix<TileType>& tiles, RandomEngine& random,
+                         GridPosition, CarveBounds bounds)
+{
+	MAZE_PROFILE_SCOPE("CarveColumns");
+
+	std::uint64_t seed = random();
+	int columns = (bounds.maxX - bounds.minX) / 2 + 1;
+	int taskCount = (columns + columnsPerTask - 1) / columnsPerTask;
+
+	auto carveColumns = [&, seed](int first, int end)
+	{
+		for (int column = first; column < end; column++)
+		{
+			RandomEngine columnRandom(seed ^ (0x9E3779B97F4A7C15ull * (column + 1)));
+			CarveColumn(tiles, columnRandom, bounds.minX + 2 * column, bounds);
+		}
+	};
+
+	if (pool == nullptr || taskCount <= 1) {
+		carveColumns(0, columns);
+	}
+	else
+	{
+		// Each task writes only its own columns and the walls between them.
+		for (int task = 0; task < taskCount; task++)
+		{
+			pool->Submit([&, task](int)
+			{
+				int first = task * columnsPerTask;
+				carveColumns(first, std::min(first + columnsPerTask, columns));
+			});
+		}
+
+		pool->Wait();
+	}
+
+	MAZE_PROFILE_COUNT("CarvedColumns", columns);
+}
+
+void ColumnCarver::WriteCells(TileType* tiles, std::uint64_t down, int tileCount)
+{
+	int tile = 0;
+
+#if defined(__AVX2__)
+	for (; tile + 32 <= tileCount; tile += 32, down >>= 16) {
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(tiles + tile),
+		                    SpreadBits(static_cast<std::uint32_t>(down & 0xFFFF), cellMasks));
+	}
+#endif
+
+	for (; tile + 8 <= tileCount; tile += 8, down >>= 4) {
+		std::memcpy(tiles + tile, cellPatterns[down & 15].data(), 8);
+	}
+
+	for (int cell = 0; tile < tileCount; tile += 2, cell++)
+	{
+		tiles[tile] = TileType::Path;
+
+		if (tile + 1 < tileCount) {
+			tiles[tile + 1] = (down >> cell & 1) ? TileType::Path : TileType::Wall;
+		}
+	}
+}
+
+void ColumnCarver::WriteWalls(TileType* tiles, std::uint64_t open, int tileCount)
+{
+	int tile = 0;
+
+#if defined(__AVX2__)
+	for (; tile + 32 <= tileCount; tile += 32, open >>= 16) {
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(tiles + tile),
+		                    SpreadBits(static_cast<std::uint32_t>(open & 0xFFFF), wallMasks));
+	}
+#endif
+
+	for (; tile + 8 <= tileCount; tile += 8, open >>= 4) {
+		std::memcpy(tiles + tile, wallPatterns[open & 15].data(), 8);
+	}
+
+	for (int cell = 0; tile < tileCount; tile += 2, cell++) {
+		tiles[tile] = (open >> cell & 1) ? TileType::Path : TileType::Wall;
+	}
+}
+
+// A column is carved a word of 64 cells at a time. The tile after the
+// last cell of the column is outside of the bounds and never written.
+void BinaryTreeCarver::CarveColumn(Matrix<TileType>& tiles, RandomEngine& random,
+                                   int x, CarveBounds bounds) const
+{
+	int rows = (bounds.maxY - bounds.minY) / 2 + 1;
+	bool lastColumn = (x == bounds.maxX);
+	TileType* cells = &tiles(x, bounds.minY);
+	TileType* walls = lastColumn ? nullptr : &tiles(x + 1, bounds.minY);
+
+	for (int first = 0; first < rows; first += 64)
+	{
+		int count = std::min(64, rows - first);
+		bool lastWord = (first + count == rows);
+		int tileCount = 2 * count - (lastWord ? 1 : 0);
+		std::uint64_t word = (count == 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+
+		std::uint64_t down = lastColumn ? word : (random() & word);
+
+		if (lastWord) {
+			down &= ~(std::uint64_t(1) << (count - 1));
+		}
+
+		WriteCells(cells + 2 * first, down, tileCount);
+
+		if (walls != nullptr) {
+			WriteWalls(walls + 2 * first, ~down & word, tileCount);
+		}
+	}
+}
+
+void SidewinderCarver::CarveColumn(Matrix<TileType>& tiles, RandomEngine& random,
+                                   int x, CarveBounds bounds) const
+{
+	int rows = (bounds.maxY - bounds.minY) / 2 + 1;
+	bool firstColumn = (x == bounds.minX);
+	TileType* cells = &tiles(x, bounds.minY);
+	TileType* walls = firstColumn ? nullptr : &tiles(x - 1, bounds.minY);
+	int runStart = 0;
+
+	for (int first = 0; first < rows; first += 64)
+	{
+		int count = std::min(64, rows - first);
+		bool lastWord = (first + count == rows);
+		int tileCount = 2 * count - (lastWord ? 1 : 0);
+		std::uint64_t word = (count == 64) ? ~std::uint64_t(0) : (std::uint64_t(1) << count) - 1;
+
+		std::uint64_t down = firstColumn ? word : (random() & word);
+
+		if (lastWord) {
+			down &= ~(std::uint64_t(1) << (count - 1));
+		}
+
+		WriteCells(cells + 2 * first, down, tileCount);
+
+		if (walls == nullptr)
+			continue;
+
+		// Every cell that does not open down ends a run.
+		for (std::uint64_t ends = ~down & word; ends != 0; ends &= ends - 1)
+		{
+			int end = first + CountTrailingZeros(ends);
+			int cell = runStart + static_cast<int>(RandomBelow(random, end - runStart + 1));
+
+			walls[2 * cell] = TileType::Path;
+			runStart = end + 1;
+		}
+	}
+}
@@ -0,0 +1,75 @@
+#ifndef COLUMN_CARVER_H
+#define COLUMN_CARVER_H
+
+#include "MazeCarver.h"
+#include <cstdint>
+
+class WorkStealingPool;
+
+// Carves every column of lattice cells on its own, so that columns can
+// be carved on several threads. Cells of a column are adjacent in the
+// column-major grid, and a column is carved 64 cells at a time from the
+// bits of a random number: the bits decide which passages are opened
+// and are spread over the tiles with whole-word stores (AVX2 where it
+// is available). Every column has its own random engine, seeded from
+// the maze and the index of the column, so the maze does not depend on
+// the number of threads. The start position plays no part.
+class ColumnCarver : public MazeCarver
+{
+	public:
+		// Columns carved by a single task on the pool.
+		static constexpr int columnsPerTask = 64;
+
+		// Columns are carved on the pool if one is given. The pool must
+		// outlive the carver.
+		explicit ColumnCarver(WorkStealingPool* pool = nullptr) : pool(pool) { }
+
+		void Carve(Matrix<TileType>& tiles, RandomEngine& random,
+		           GridPosition startPosition, CarveBounds bounds) override;
+
+	protected:
+		// Carves the cells of the column at x, writing only to that column
+		// and to the wall columns on either side of it.
+		virtual void CarveColumn(Matrix<TileType>& tiles, RandomEngine& random,
+		                         int x, CarveBounds bounds) const = 0;
+
+		// Opens the cells of a column and the passages below the cells
+		// whose bit is set, tileCount tiles from the first one.
+		static void WriteCells(TileType* tiles, std::uint64_t down, int tileCount);
+		// Opens the tiles of a wall column next to the cells whose bit is set.
+		static void WriteWalls(TileType* tiles, std::uint64_t open, int tileCount);
+
+	private:
+		WorkStealingPool* pool;
+};
+
+// Every cell opens a passage either down or right, with a coin flip for
+// each. Cells of the last row can only go right and cells of the last
+// column only down. Makes long corridors along the bottom and right
+// edges, and no dead end ever points up or left.
+class BinaryTreeCarver : public ColumnCarver
+{
+	public:
+		using ColumnCarver::ColumnCarver;
+
+	protected:
+		void CarveColumn(Matrix<TileType>& tiles, RandomEngine& random,
+		                 int x, CarveBounds bounds) const override;
+};
+
+// The sidewinder algorithm along columns: a column is split into runs
+// of cells joined by passages down, with a coin flip after each cell
+// ending the run. Every run then opens a single passage left, from a
+// random cell of it, into the previous column. The first column is one
+// run from top to bottom. Makes a single corridor along the left edge.
+class SidewinderCarver : public ColumnCarver
+{
+	public:
+		using ColumnCarver::ColumnCarver;
+
+	protected:
+		void CarveColumn(Matrix<TileType>& tiles, RandomEngine& random,
+		                 int x, CarveBounds bounds) const override;
+};
+
+#endif
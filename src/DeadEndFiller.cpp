@@ -0,0 +1,298 @@
+#include "DeadEndFiller.h"
+#include "Maze.h"
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static int PopCount(std::uint64_t bits)
+{
+#if defined(_MSC_VER)
+	return static_cast<int>(__popcnt64(bits));
+#else
+	return __builtin_popcountll(bits);
+#endif
+}
+
+// Keeps the cells of a row that have at least two open neighbours.
+// left and right hold the row shifted by one cell, so bit x of
+// them is the cell to the left and to the right of x.
+static std::uint64_t KeepCorridors(std::uint64_t row, std::uint64_t up, std::uint64_t down,
+				   std::uint64_t left, std::uint64_t right, std::uint64_t keep)
+{
+	std::uint64_t atLeastTwo = (up & (down | left | right)) | (down & (left | right)) | (left & right);
+	return row & (atLeastTwo | keep);
+}
+
+std::uint64_t DeadEndFiller::Fill(const Maze& maze)
+{
+	Load(maze);
+
+	std::uint64_t openBefore = CountOpen();
+	passCount = 0;
+
+	// Whole-grid sweeps remove most of the short dead ends. Sweeping
+	// down and then up lets a vertical dead end collapse in a single
+	// sweep, whichever way it points. Sweeping stops when a pass does
+	// not change anything. Once a pass fills less than a quarter of
+	// the open cells, the long branches that are left are filled word
+	// by word instead.
+	std::uint64_t openCount = openBefore;
+
+	while (true)
+	{
+		passCount++;
+
+		std::fill(rowChanged.begin(), rowChanged.end(), 0);
+
+		for (int y = 0; y < height; y++) {
+			rowChanged[y] |= FillRow(y) ? 1 : 0;
+		}
+
+		for (int y = height - 1; y >= 0; y--) {
+			rowChanged[y] |= FillRow(y) ? 1 : 0;
+		}
+
+		std::uint64_t openAfter = CountOpen();
+		std::uint64_t filled = openCount - openAfter;
+		openCount = openAfter;
+
+		if (filled == 0)
+			break;
+
+		if (filled * 4 < openCount)
+		{
+			FillRemaining();
+			break;
+		}
+	}
+
+	return openBefore - CountOpen();
+}
+
+// Fills the long dead-end branches that are left after the sweeps.
+// Only the words next to a change are revisited, so the cost depends
+// on the number of filled cells instead of the size of the grid.
+void DeadEndFiller::FillRemaining()
+{
+	worklist.clear();
+	queued.assign((rows.size() + 63) / 64, 0);
+
+	for (int y = 0; y < height; y++)
+	{
+		bool nearChange = rowChanged[y] || 
+		                  (y > 0 && rowChanged[y - 1]) || 
+		                  (y < height - 1 && rowChanged[y + 1]);
+
+		if (!nearChange)
+			continue;
+
+		for (int i = 0; i < wordsPerRow; i++) {
+			Enqueue(RowOffset(y) + i);
+		}
+	}
+
+	while (!worklist.empty())
+	{
+		std::size_t offset = worklist.back();
+		worklist.pop_back();
+		queued[offset >> 6] &= ~(1ull << (offset & 63));
+
+		FillWord(offset);
+	}
+}
+
+// Fills the dead ends of a single word until it does not change,
+// and queues the neighbouring words that may have become dead ends.
+void DeadEndFiller::FillWord(std::size_t offset)
+{
+	int y = static_cast<int>(offset / stride) - 1;
+	int i = static_cast<int>(offset % stride) - 1;
+
+	std::uint64_t keep = 0;
+
+	if (start.y == y && (start.x >> 6) == i) {
+		keep |= 1ull << (start.x & 63);
+	}
+
+	if (exit.y == y && (exit.x >> 6) == i) {
+		keep |= 1ull << (exit.x & 63);
+	}
+
+	std::uint64_t original = rows[offset];
+	std::uint64_t current = original;
+
+	while (true)
+	{
+		std::uint64_t left = (current << 1) | (rows[offset - 1] >> 63);
+		std::uint64_t right = (current >> 1) | (rows[offset + 1] << 63);
+		std::uint64_t result = KeepCorridors(current, rows[offset - stride], rows[offset + stride],
+		                                     left, right, keep);
+		if (result == current)
+			break;
+
+		current = result;
+	}
+
+	std::uint64_t removed = original ^ current;
+
+	if (removed == 0)
+		return;
+
+	rows[offset] = current;
+
+	if (y > 0) {
+		Enqueue(offset - stride);
+	}
+
+	if (y < height - 1) {
+		Enqueue(offset + stride);
+	}
+
+	if ((removed & 1) && i > 0) {
+		Enqueue(offset - 1);
+	}
+
+	if ((removed >> 63) && i < wordsPerRow - 1) {
+		Enqueue(offset + 1);
+	}
+}
+
+void DeadEndFiller::Enqueue(std::size_t offset)
+{
+	std::uint64_t bit = 1ull << (offset & 63);
+
+	if (queued[offset >> 6] & bit)
+		return;
+
+	queued[offset >> 6] |= bit;
+	worklist.push_back(static_cast<std::uint32_t>(offset));
+}
+
+// Converts the tiles of the maze into bitboards of open cells.
+void DeadEndFiller::Load(const Maze& maze)
+{
+	const Matrix<TileType>& tiles = maze.GetTiles();
+
+	width = maze.GetWidth();
+	height = maze.GetHeight();
+	start = maze.GetStartPosition();
+	exit = maze.GetExitPosition();
+
+	// Rows are rounded up to whole AVX2 vectors.
+	wordsPerRow = ((width + 255) / 256) * 4;
+	stride = wordsPerRow + 2;
+
+	rows.assign(static_cast<std::size_t>(height + 2) * stride, 0);
+	keepRow.assign(stride, 0);
+	emptyRow.assign(stride, 0);
+	rowChanged.resize(height);
+
+	for (int y = 0; y < height; y++)
+	{
+		std::uint64_t* row = &rows[RowOffset(y)];
+
+		for (int x = 0; x < width; x++)
+		{
+			if (tiles(x, y) != TileType::Wall) {
+				row[x >> 6] |= 1ull << (x & 63);
+			}
+		}
+	}
+}
+
+// Fills the dead ends of a single row until the row does not change.
+// Returns true if any cell was filled.
+bool DeadEndFiller::FillRow(int y)
+{
+	std::uint64_t* row = &rows[RowOffset(y)];
+	const std::uint64_t* up = &rows[RowOffset(y - 1)];
+	const std::uint64_t* down = &rows[RowOffset(y + 1)];
+	const std::uint64_t* keep = &emptyRow[1];
+
+	// The start and the exit are never filled.
+	if (y == start.y || y == exit.y)
+	{
+		std::fill(keepRow.begin(), keepRow.end(), 0);
+
+		if (y == start.y) {
+			keepRow[1 + (start.x >> 6)] |= 1ull << (start.x & 63);
+		}
+
+		if (y == exit.y) {
+			keepRow[1 + (exit.x >> 6)] |= 1ull << (exit.x & 63);
+		}
+
+		keep = &keepRow[1];
+	}
+
+	bool changed = false;
+	std::uint64_t difference;
+
+	do
+	{
+		difference = 0;
+		int i = 0;
+
+#if defined(__AVX2__)
+		__m256i vectorDifference = _mm256_setzero_si256();
+
+		for (; i + 4 <= wordsPerRow; i += 4)
+		{
+			__m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+			__m256i previous = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i - 1));
+			__m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i + 1));
+			__m256i above = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(up + i));
+			__m256i below = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(down + i));
+			__m256i kept = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keep + i));
+
+			__m256i left = _mm256_or_si256(_mm256_slli_epi64(current, 1), _mm256_srli_epi64(previous, 63));
+			__m256i right = _mm256_or_si256(_mm256_srli_epi64(current, 1), _mm256_slli_epi64(next, 63));
+
+			__m256i atLeastTwo = _mm256_or_si256(
+				_mm256_and_si256(above, _mm256_or_si256(below, _mm256_or_si256(left, right))),
+				_mm256_or_si256(_mm256_and_si256(below, _mm256_or_si256(left, right)),
+				                _mm256_and_si256(left, right)));
+
+			__m256i result = _mm256_and_si256(current, _mm256_or_si256(atLeastTwo, kept));
+
+			vectorDifference = _mm256_or_si256(vectorDifference, _mm256_xor_si256(current, result));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), result);
+		}
+
+		difference = _mm256_testz_si256(vectorDifference, vectorDifference) ? 0 : 1;
+#endif
+
+		for (; i < wordsPerRow; i++)
+		{
+			std::uint64_t current = row[i];
+			std::uint64_t left = (current << 1) | (row[i - 1] >> 63);
+			std::uint64_t right = (current >> 1) | (row[i + 1] << 63);
+			std::uint64_t result = KeepCorridors(current, up[i], down[i], left, right, keep[i]);
+
+			difference |= current ^ result;
+			row[i] = result;
+		}
+
+		changed |= (difference != 0);
+	}
+	while (difference != 0);
+
+	return changed;
+}
+
+std::uint64_t DeadEndFiller::CountOpen() const
+{
+	std::uint64_t count = 0;
+
+	for (std::uint64_t word : rows) {
+		count += PopCount(word);
+	}
+
+	return count;
+}
@@ -0,0 +1,65 @@
+#ifndef DEAD_END_FILLER_H
+#define DEAD_END_FILLER_H
+
+#include "Grid.h"
+#include <cstdint>
+#include <vector>
+
+class Maze;
+
+// Solves a maze without searching: every open cell with at most one
+// open neighbour (a dead end) is filled, until only the cells between
+// the start and the exit remain. In a perfect maze that is exactly
+// the solution path.
+//
+// Open cells are stored as bitboards, 64 cells per word, so a whole
+// row is processed with a handful of shifts and bitwise operations.
+// When the compiler targets AVX2, four words are processed at a time.
+// The last long dead-end branches are filled through a worklist of
+// words, so that the grid is not swept over and over again.
+class DeadEndFiller
+{
+	public:
+		// Fills the dead ends of the maze. Returns the number of cells filled.
+		std::uint64_t Fill(const Maze& maze);
+
+		// Returns true if the cell is open and was not filled.
+		bool IsOpen(int x, int y) const
+		{
+			return (rows[RowOffset(y) + (x >> 6)] >> (x & 63)) & 1;
+		}
+
+		int GetPassCount() const { return passCount; }
+
+	private:
+		// Each row is padded with a zero word on both sides and there is
+		// a zero row above and below the grid, so that neighbours can be
+		// read without bounds checks.
+		std::vector<std::uint64_t> rows;
+		std::vector<std::uint64_t> keepRow;
+		std::vector<std::uint64_t> emptyRow;
+		std::vector<std::uint8_t> rowChanged;
+		std::vector<std::uint32_t> worklist;
+		std::vector<std::uint64_t> queued;
+		int width {0};
+		int height {0};
+		int wordsPerRow {0};
+		int stride {0};
+		int passCount {0};
+		GridPosition start;
+		GridPosition exit;
+
+		void Load(const Maze& maze);
+		bool FillRow(int y);
+		void FillRemaining();
+		void FillWord(std::size_t offset);
+		void Enqueue(std::size_t offset);
+		std::uint64_t CountOpen() const;
+
+		std::size_t RowOffset(int y) const
+		{
+			return static_cast<std::size_t>(y + 1) * stride + 1;
+		}
+};
+
+#endif
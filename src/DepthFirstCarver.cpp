@@ -0,0 +1,90 @@
+#include "DepthFirstCarver.h"
+#include "Profiler.h"
+
+// Creates the actual maze by going to four random directions
+// and knocking walls in the path, starting from startPosition.
+void DepthFirstCarver::Carve(Matrix<TileType>& tiles, RandomEngine& random,
+			     GridPosition startPosition, CarveBounds bounds)
+{
+	MAZE_PROFILE_SCOPE("Carve");
+
+	this->tiles = &tiles;
+	this->random = &random;
+	this->bounds = bounds;
+
+	stack.clear();
+	stack.reserve(GetMaxDepth(bounds));
+
+	tiles[startPosition.x][startPosition.y] = TileType::Path;
+	PushFrame(startPosition);
+
+	while (!stack.empty())
+	{
+		CarveFrame& frame = stack.back();
+
+		if (frame.next == 4)
+		{
+			// Every direction has been tried, backtrack.
+			stack.pop_back();
+			continue;
+		}
+
+		auto direction = static_cast<Direction>((frame.directions >> (frame.next * 2)) & 3);
+		frame.next++;
+
+		int width = tiles.GetWidth();
+		GridPosition currentPosition = { static_cast<int>(frame.index % width),
+			                         static_cast<int>(frame.index / width) };
+		GridPosition nextPosition;
+
+		if (KnockWall(direction, currentPosition, nextPosition)) {
+			PushFrame(nextPosition);
+		}
+	}
+}
+
+// Adds a cell to the carving stack along with a random order
+// in which its neighbours are visited.
+void DepthFirstCarver::PushFrame(GridPosition position)
+{
+	CarveFrame frame;
+	frame.index = static_cast<std::uint32_t>(position.y) * tiles->GetWidth() + position.x;
+	frame.directions = directionOrders[RandomBelow(*random, 24)];
+	frame.next = 0;
+
+	stack.push_back(frame);
+}
+
+// Tries to knock down a wall from a position to a given direction.
+// Returns false if index is out of bounds or the cell behind the
+// wall has already been carved. Otherwise outPosition is set to
+// the newly carved cell.
+bool DepthFirstCarver::KnockWall(Direction direction, GridPosition currentPosition,
+			      GridPosition& outPosition)
+{
+	Matrix<TileType>& tiles = *this->tiles;
+	GridPosition step = GetStep(direction);
+	int x = currentPosition.x + 2 * step.x;
+	int y = currentPosition.y + 2 * step.y;
+
+	if (x < bounds.minX || x > bounds.maxX || y < bounds.minY || y > bounds.maxY)
+		return false;
+	if (tiles[x][y] == TileType::Path)
+		return false;
+
+	tiles[currentPosition.x + step.x][currentPosition.y + step.y] = TileType::Path;
+	tiles[x][y] = TileType::Path;
+	outPosition = { x, y };
+	return true;
+}
+
+std::size_t DepthFirstCarver::GetMaxDepth(CarveBounds bounds)
+{
+	return static_cast<std::size_t>((bounds.maxX - bounds.minX) / 2 + 1) * 
+	       ((bounds.maxY - bounds.minY) / 2 + 1);
+}
+
+std::size_t DepthFirstCarver::GetMaxStackBytes(CarveBounds bounds)
+{
+	return GetMaxDepth(bounds) * sizeof(CarveFrame);
+}
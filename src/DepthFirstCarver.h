@@ -0,0 +1,55 @@
+#ifndef DEPTH_FIRST_CARVER_H
+#define DEPTH_FIRST_CARVER_H
+
+#include "MazeCarver.h"
+#include <cstdint>
+#include <vector>
+
+// Carves a spanning tree through the lattice cells of a rectangle
+// with a randomized depth-first search. The search uses an explicit
+// stack instead of recursion, so that the length of a corridor is not
+// limited by the size of the thread stack. The stack is kept between
+// calls, so a carver can be reused without allocating.
+class DepthFirstCarver : public MazeCarver
+{
+	public:
+		// Every order in which the four directions can be tried, packed
+		// two bits per direction. Picking one of these with a single random
+		// number is cheaper than shuffling the directions for each cell.
+		static constexpr std::uint8_t directionOrders[24] =
+		{
+			0xE4, 0xB4, 0xD8, 0x78, 0x9C, 0x6C, 0xE1, 0xB1, 0xC9, 0x39, 0x8D, 0x2D,
+			0xD2, 0x72, 0xC6, 0x36, 0x4E, 0x1E, 0x93, 0x63, 0x87, 0x27, 0x4B, 0x1B
+		};
+
+		void Carve(Matrix<TileType>& tiles, RandomEngine& random,
+		           GridPosition startPosition, CarveBounds bounds) override;
+
+		// The carving stack never holds more frames than there are
+		// lattice cells in the bounds, so its peak memory is known
+		// before carving starts.
+		static std::size_t GetMaxDepth(CarveBounds bounds);
+		static std::size_t GetMaxStackBytes(CarveBounds bounds);
+
+	private:
+		// A cell on the carving stack. The four directions are packed
+		// two bits each in the order they are tried; next is the index
+		// of the direction to try next.
+		struct CarveFrame
+		{
+			std::uint32_t index;
+			std::uint8_t directions;
+			std::uint8_t next;
+		};
+
+		std::vector<CarveFrame> stack;
+		Matrix<TileType>* tiles {nullptr};
+		RandomEngine* random {nullptr};
+		CarveBounds bounds;
+
+		void PushFrame(GridPosition position);
+		bool KnockWall(Direction direction, GridPosition currentPosition,
+			       GridPosition& outPosition);
+};
+
+#endif
@@ -0,0 +1,55 @@
+#include "DistanceField.h"
+#include "Profiler.h"
+#include <numeric>
+
+void DistanceField::Build(const Maze& maze)
+{
+	MAZE_PROFILE_SCOPE("BuildDistanceField");
+
+	int width = maze.GetWidth();
+	int height = maze.GetHeight();
+	const Matrix<TileType>& tiles = maze.GetTiles();
+	std::size_t cellCount = static_cast<std::size_t>(width) * height;
+
+	distances.assign(cellCount, unreachable);
+	next.resize(cellCount);
+	std::iota(next.begin(), next.end(), 0u);
+
+	// Every open cell is visited once, so the frontier never grows
+	// past the number of cells.
+	frontier.clear();
+	frontier.reserve(cellCount);
+
+	exit = maze.GetIndex(maze.GetExitPosition());
+	distances[exit] = 0;
+	frontier.push_back(exit);
+
+	for (std::size_t head = 0; head < frontier.size(); head++)
+	{
+		std::uint32_t current = frontier[head];
+		int x = static_cast<int>(current % width);
+		int y = static_cast<int>(current / width);
+
+		const int offsetsX[4] = { 0, 1, 0, -1 };
+		const int offsetsY[4] = { -1, 0, 1, 0 };
+
+		for (int direction = 0; direction < 4; direction++)
+		{
+			int neighbourX = x + offsetsX[direction];
+			int neighbourY = y + offsetsY[direction];
+
+			if (neighbourX < 0 || neighbourX >= width || neighbourY < 0 || neighbourY >= height ||
+			    tiles(neighbourX, neighbourY) == TileType::Wall)
+				continue;
+
+			std::uint32_t neighbour = static_cast<std::uint32_t>(neighbourY) * width + neighbourX;
+
+			if (distances[neighbour] != unreachable)
+				continue;
+
+			distances[neighbour] = distances[current] + 1;
+			next[neighbour] = current;
+			frontier.push_back(neighbour);
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#ifndef DISTANCE_FIELD_H
+#define DISTANCE_FIELD_H
+
+#include "Maze.h"
+#include <cstdint>
+#include <vector>
+
+// The distance from every cell of a maze to its exit, found with a 
+// single breadth-first search from the exit. Along with the distance,
+// every cell stores the neighbour one step closer to the exit, so
+// walking to the exit from anywhere is one table lookup per step.
+// Cells are identified by their index y * width + x, like in Maze.
+class DistanceField
+{
+	public:
+		static constexpr std::uint32_t unreachable = 0xFFFFFFFF;
+
+		void Build(const Maze& maze);
+
+		std::uint32_t GetDistance(std::uint32_t index) const { return distances[index]; }
+
+		// The next cell towards the exit. The exit, walls and cells that
+		// cannot reach the exit lead to themselves.
+		std::uint32_t GetNext(std::uint32_t index) const { return next[index]; }
+		const std::uint32_t* GetNextTable() const { return next.data(); }
+
+		std::uint32_t GetExit() const { return exit; }
+		std::size_t GetCellCount() const { return next.size(); }
+
+	private:
+		std::vector<std::uint32_t> distances;
+		std::vector<std::uint32_t> next;
+		std::vector<std::uint32_t> frontier;
+		std::uint32_t exit {0};
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef FIXED_MATRIX_H
+#define FIXED_MATRIX_H
+
+#include "Matrix.h"
+#include <array>
+#include <cstddef>
+
+// A Matrix whose size is known at compile time. Cells are stored in an
+// std::array in the same column-major order as Matrix, so the index of
+// every cell is folded into constants wherever its coordinates are,
+// and there is no heap allocation to go through. Every operation is
+// constexpr, so a FixedMatrix can be filled in at compile time.
+template <class T, int Width, int Height>
+struct FixedMatrix
+{
+	static_assert(Width > 0 && Height > 0, "FixedMatrix needs at least one cell");
+
+	static constexpr std::size_t cellCount = static_cast<std::size_t>(Width) * Height;
+
+	std::array<T, cellCount> cells {};
+
+	static constexpr int GetWidth() { return Width; }
+	static constexpr int GetHeight() { return Height; }
+
+	constexpr const T& operator()(int x, int y) const
+	{
+		return cells[static_cast<std::size_t>(x) * Height + y];
+	}
+
+	constexpr T& operator()(int x, int y)
+	{
+		return cells[static_cast<std::size_t>(x) * Height + y];
+	}
+
+	constexpr T* data() { return cells.data(); }
+	constexpr const T* data() const { return cells.data(); }
+	static constexpr std::size_t size() { return cellCount; }
+
+	constexpr void Fill(const T& value)
+	{
+		for (T& cell : cells) {
+			cell = value;
+		}
+	}
+
+	// A copy with its size decided at run time. The layouts match, so
+	// this is a single copy of the buffer.
+	Matrix<T> ToMatrix() const
+	{
+		Matrix<T> matrix(Width, Height);
+		std::copy(cells.begin(), cells.end(), matrix.data());
+		return matrix;
+	}
+};
+
+#endif
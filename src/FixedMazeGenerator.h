@@ -0,0 +1,128 @@
+#ifndef FIXED_MAZE_GENERATOR_H
+#define FIXED_MAZE_GENERATOR_H
+
+#include "FixedMatrix.h"
+#include "DepthFirstCarver.h"
+#include "Maze.h"
+#include "Random.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+
+// A maze of a size known at compile time. Holds no pointers, so it
+// can be a constexpr variable and end up in the binary as static data.
+template <int Width, int Height>
+struct FixedMaze
+{
+	FixedMatrix<TileType, Width, Height> tiles;
+	GridPosition startPosition;
+	GridPosition exitPosition;
+	std::uint64_t seed {0};
+
+	std::unique_ptr<Maze> ToMaze() const
+	{
+		return std::make_unique<Maze>(tiles.ToMatrix(), startPosition, exitPosition, seed);
+	}
+};
+
+// Generates mazes of a fixed size with the same depth-first search and
+// the same random numbers as MazeGenerator::Create, so a seed gives the
+// same maze from both. Generation is constexpr: a level with a fixed
+// seed can be baked into the binary with
+//
+//     static constexpr FixedMaze<21, 21> level = FixedMazeGenerator<21, 21>::Create(42);
+//
+// which costs nothing at startup. Compilers limit the work done in a
+// constant expression; larger levels may need a higher limit
+// (-fconstexpr-ops-limit on GCC, /constexpr:steps on MSVC). At run time,
+// the maze and the carving stack live on the thread stack, so this is
+// meant for small levels.
+template <int Width, int Height>
+class FixedMazeGenerator
+{
+	static_assert(Width % 2 == 1 && Height % 2 == 1, "Width and Height must be odd");
+	static_assert(Width >= 3 && Height >= 3, "A maze needs at least one cell inside the border");
+
+	public:
+		static constexpr FixedMaze<Width, Height> Create(std::uint64_t seed)
+		{
+			FixedMaze<Width, Height> maze;
+			maze.seed = seed;
+			maze.tiles.Fill(TileType::Wall);
+
+			RandomEngine random(seed);
+			maze.startPosition.x = 1 + 2 * static_cast<int>(RandomBelow(random, columns));
+			maze.startPosition.y = 1 + 2 * static_cast<int>(RandomBelow(random, rows));
+
+			Carve(maze.tiles, random, maze.startPosition);
+			maze.exitPosition = CreateExit(maze.tiles, random);
+			return maze;
+		}
+
+	private:
+		typedef FixedMatrix<TileType, Width, Height> Tiles;
+
+		static constexpr int columns = (Width - 1) / 2;
+		static constexpr int rows = (Height - 1) / 2;
+
+		// A cell on the carving stack, as in DepthFirstCarver.
+		struct CarveFrame
+		{
+			int x {0};
+			int y {0};
+			std::uint8_t directions {0};
+			std::uint8_t next {0};
+		};
+
+		static constexpr void Carve(Tiles& tiles, RandomEngine& random, GridPosition startPosition)
+		{
+			// The stack never holds more frames than there are cells.
+			std::array<CarveFrame, static_cast<std::size_t>(columns) * rows> stack {};
+			std::size_t depth = 0;
+
+			tiles(startPosition.x, startPosition.y) = TileType::Path;
+			stack[depth++] = { startPosition.x, startPosition.y,
+			                   DepthFirstCarver::directionOrders[RandomBelow(random, 24)], 0 };
+
+			while (depth > 0)
+			{
+				CarveFrame& frame = stack[depth - 1];
+
+				if (frame.next == 4)
+				{
+					// Every direction has been tried, backtrack.
+					depth--;
+					continue;
+				}
+
+				auto direction = static_cast<Direction>((frame.directions >> (frame.next * 2)) & 3);
+				frame.next++;
+
+				GridPosition step = GetStep(direction);
+				int x = frame.x + 2 * step.x;
+				int y = frame.y + 2 * step.y;
+
+				if (x < 1 || x > Width - 2 || y < 1 || y > Height - 2 || tiles(x, y) == TileType::Path)
+					continue;
+
+				tiles(frame.x + step.x, frame.y + step.y) = TileType::Path;
+				tiles(x, y) = TileType::Path;
+				stack[depth++] = { x, y, DepthFirstCarver::directionOrders[RandomBelow(random, 24)], 0 };
+			}
+		}
+
+		// Opens an odd tile of the border next to a carved cell, picked
+		// the same way as MazeGenerator::CreateRandomExit.
+		static constexpr GridPosition CreateExit(Tiles& tiles, RandomEngine& random)
+		{
+			int index = static_cast<int>(RandomBelow(random, GetExitCount(Width, Height)));
+			GridPosition exit = GetExitPosition(index, Width, Height);
+			GridPosition inside = GetExitNeighbour(exit, Width, Height);
+
+			tiles(exit.x, exit.y) = TileType::Exit;
+			tiles(inside.x, inside.y) = TileType::Path;
+			return exit;
+		}
+};
+
+#endif
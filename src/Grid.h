@@ -0,0 +1,84 @@
+#ifndef GRID_H
+#define GRID_H
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+
+// The type of a single cell. Stored as a single byte so that
+// the grid stays compact even for very large mazes.
+enum class TileType : std::uint8_t { Path, Wall, Exit };
+
+enum class Direction : std::uint8_t { Up, Down, Left, Right };
+
+// A position on the grid, measured in cells.
+struct GridPosition
+{
+	int x {0};
+	int y {0};
+};
+
+inline bool operator==(GridPosition a, GridPosition b)
+{
+	return a.x == b.x && a.y == b.y;
+}
+
+inline bool operator!=(GridPosition a, GridPosition b)
+{
+	return !(a == b);
+}
+
+// The step of a single tile in a direction.
+constexpr GridPosition GetStep(Direction direction)
+{
+	return { (direction == Direction::Left) ? -1 : (direction == Direction::Right) ? 1 : 0,
+	         (direction == Direction::Up) ? -1 : (direction == Direction::Down) ? 1 : 0 };
+}
+
+// The number of places for the exit of a maze: every odd tile of the
+// border, where the tile inside is a cell of the lattice.
+constexpr int GetExitCount(int width, int height)
+{
+	return 2 * ((width - 1) / 2 + (height - 1) / 2);
+}
+
+// The place of the exit for an index below GetExitCount. The odd
+// positions of the top and bottom borders come first, followed by the
+// odd positions of the left and right borders.
+constexpr GridPosition GetExitPosition(int index, int width, int height)
+{
+	int columns = (width - 1) / 2;
+
+	if (index < 2 * columns) {
+		return { 1 + 2 * (index / 2), (index % 2 == 0) ? 0 : height - 1 };
+	}
+
+	index -= 2 * columns;
+	return { (index % 2 == 0) ? 0 : width - 1, 1 + 2 * (index / 2) };
+}
+
+// The number of open tiles of a perfect maze on the lattice: every
+// cell, a passage for every cell but the first, and the exit. Roughly
+// half of the tiles; a breadth-first frontier or a path through such a
+// maze never holds more.
+constexpr std::size_t GetOpenTileCount(int width, int height)
+{
+	return 2 * static_cast<std::size_t>(width / 2) * (height / 2);
+}
+
+// The tile inside the exit, which has to be open. The exit must be on
+// the border.
+constexpr GridPosition GetExitNeighbour(GridPosition exit, int width, int height)
+{
+	if (exit.x == 0)
+		return { exit.x + 1, exit.y };
+	if (exit.x == width - 1)
+		return { exit.x - 1, exit.y };
+	if (exit.y == 0)
+		return { exit.x, exit.y + 1 };
+
+	assert(exit.y == height - 1);
+	return { exit.x, exit.y - 1 };
+}
+
+#endif
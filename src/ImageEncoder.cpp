@@ -0,0 +1,213 @@
+#include "ImageEncoder.h"
+#include <algorithm>
+#include <cstring>
+
+// Bytes in front of the data of every block: the zlib header, which
+// only the first block writes, and the header of the stored block.
+static const std::size_t zlibHeaderSize = 2;
+static const std::size_t blockHeaderSize = 5;
+static const std::size_t blockPrefixSize = zlibHeaderSize + blockHeaderSize;
+
+static void WriteBigEndian(std::uint8_t* out, std::uint32_t value)
+{
+	out[0] = static_cast<std::uint8_t>(value >> 24);
+	out[1] = static_cast<std::uint8_t>(value >> 16);
+	out[2] = static_cast<std::uint8_t>(value >> 8);
+	out[3] = static_cast<std::uint8_t>(value);
+}
+
+// The CRC-32 of PNG chunks, eight bytes at a time with eight tables.
+static std::uint32_t UpdateCrc(std::uint32_t crc, const std::uint8_t* data, std::size_t size)
+{
+	static const auto tables = []()
+	{
+		std::vector<std::uint32_t> values(8 * 256);
+
+		for (std::uint32_t byte = 0; byte < 256; byte++)
+		{
+			std::uint32_t value = byte;
+
+			for (int bit = 0; bit < 8; bit++) {
+				value = (value & 1) ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+			}
+
+			values[byte] = value;
+		}
+
+		for (std::size_t i = 256; i < values.size(); i++) {
+			values[i] = (values[i - 256] >> 8) ^ values[values[i - 256] & 0xFF];
+		}
+
+		return values;
+	}();
+
+	const std::uint32_t* table = tables.data();
+	crc = ~crc;
+
+	for (; size >= 8; size -= 8, data += 8)
+	{
+		std::uint32_t low = crc ^ (data[0] | data[1] << 8 | data[2] << 16 | static_cast<std::uint32_t>(data[3]) << 24);
+
+		crc = table[7 * 256 + (low & 0xFF)] ^ table[6 * 256 + (low >> 8 & 0xFF)] ^
+		      table[5 * 256 + (low >> 16 & 0xFF)] ^ table[4 * 256 + (low >> 24)] ^
+		      table[3 * 256 + data[4]] ^ table[2 * 256 + data[5]] ^
+		      table[1 * 256 + data[6]] ^ table[data[7]];
+	}
+
+	for (; size > 0; size--, data++) {
+		crc = table[(crc ^ *data) & 0xFF] ^ (crc >> 8);
+	}
+
+	return ~crc;
+}
+
+// The Adler-32 checksum of the zlib stream. The sums are reduced only
+// every 5552 bytes, the most that cannot overflow 32 bits.
+static std::uint32_t UpdateAdler(std::uint32_t adler, const std::uint8_t* data, std::size_t size)
+{
+	const std::uint32_t modulus = 65521;
+	std::uint32_t a = adler & 0xFFFF;
+	std::uint32_t b = adler >> 16;
+
+	while (size > 0)
+	{
+		std::size_t count = std::min<std::size_t>(size, 5552);
+		size -= count;
+
+		for (; count > 0; count--)
+		{
+			a += *data++;
+			b += a;
+		}
+
+		a %= modulus;
+		b %= modulus;
+	}
+
+	return (b << 16) | a;
+}
+
+bool ImageEncoder::Write(const void* data, std::size_t size)
+{
+	if (!failed && std::fwrite(data, 1, size, file) != size) {
+		failed = true;
+	}
+
+	bytesWritten += size;
+	return !failed;
+}
+
+bool PpmEncoder::Begin(std::FILE* file, int width, int height)
+{
+	this->file = file;
+	this->width = width;
+	this->height = height;
+	bytesWritten = 0;
+	failed = false;
+
+	char header[64];
+	int length = std::snprintf(header, sizeof(header), "P6\n%d %d\n255\n", width, height);
+	return Write(header, length);
+}
+
+bool PpmEncoder::WriteRow(const std::uint8_t* pixels)
+{
+	return Write(pixels, static_cast<std::size_t>(width) * 3);
+}
+
+bool PpmEncoder::End()
+{
+	return !failed && std::fflush(file) == 0;
+}
+
+bool PngEncoder::Begin(std::FILE* file, int width, int height)
+{
+	this->file = file;
+	this->width = width;
+	this->height = height;
+	bytesWritten = 0;
+	failed = false;
+	adler = 1;
+	headerWritten = false;
+
+	const std::uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	std::uint8_t header[13] = {};
+	WriteBigEndian(header, static_cast<std::uint32_t>(width));
+	WriteBigEndian(header + 4, static_cast<std::uint32_t>(height));
+	header[8] = 8; // bits per channel
+	header[9] = 2; // RGB
+
+	block.reserve(blockPrefixSize + maxBlockSize + 4);
+	block.assign(blockPrefixSize, 0);
+
+	return Write(signature, sizeof(signature)) && WriteChunk("IHDR", header, sizeof(header));
+}
+
+// Every row starts with its filter type, which is always none.
+bool PngEncoder::WriteRow(const std::uint8_t* pixels)
+{
+	const std::uint8_t filter = 0;
+	Append(&filter, 1);
+	Append(pixels, static_cast<std::size_t>(width) * 3);
+	return !failed;
+}
+
+bool PngEncoder::End()
+{
+	return FlushBlock(true) && WriteChunk("IEND", nullptr, 0) && std::fflush(file) == 0;
+}
+
+void PngEncoder::Append(const std::uint8_t* data, std::size_t size)
+{
+	while (size > 0 && !failed)
+	{
+		std::size_t count = std::min(size, blockPrefixSize + maxBlockSize - block.size());
+		block.insert(block.end(), data, data + count);
+		data += count;
+		size -= count;
+
+		if (block.size() == blockPrefixSize + maxBlockSize) {
+			FlushBlock(false);
+		}
+	}
+}
+
+bool PngEncoder::WriteChunk(const char* type, const std::uint8_t* data, std::size_t size)
+{
+	std::uint8_t length[4];
+	std::uint8_t crc[4];
+	WriteBigEndian(length, static_cast<std::uint32_t>(size));
+	WriteBigEndian(crc, UpdateCrc(UpdateCrc(0, reinterpret_cast<const std::uint8_t*>(type), 4), data, size));
+
+	return Write(length, 4) && Write(type, 4) && (size == 0 || Write(data, size)) && Write(crc, 4);
+}
+
+// Fills in the headers in front of the data and writes the block. The
+// last block also carries the checksum that ends the zlib stream.
+bool PngEncoder::FlushBlock(bool last)
+{
+	std::size_t dataSize = block.size() - blockPrefixSize;
+	adler = UpdateAdler(adler, block.data() + blockPrefixSize, dataSize);
+
+	std::uint8_t* prefix = block.data();
+	prefix[0] = 0x78; // deflate with a 32 KB window
+	prefix[1] = 0x01; // no preset dictionary, checked by the first byte
+	prefix[2] = last ? 1 : 0;
+	prefix[3] = static_cast<std::uint8_t>(dataSize);
+	prefix[4] = static_cast<std::uint8_t>(dataSize >> 8);
+	prefix[5] = static_cast<std::uint8_t>(~dataSize);
+	prefix[6] = static_cast<std::uint8_t>(~dataSize >> 8);
+
+	if (last)
+	{
+		block.resize(block.size() + 4);
+		WriteBigEndian(&block[block.size() - 4], adler);
+	}
+
+	std::size_t skip = headerWritten ? zlibHeaderSize : 0;
+	headerWritten = true;
+
+	WriteChunk("IDAT", block.data() + skip, block.size() - skip);
+	block.resize(blockPrefixSize);
+	return !failed;
+}
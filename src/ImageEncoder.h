@@ -0,0 +1,69 @@
+#ifndef IMAGE_ENCODER_H
+#define IMAGE_ENCODER_H
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Writes an RGB image to a file one row at a time, top to bottom, so
+// that no more than a row of the image has to be in memory. The file
+// is opened and closed by the caller. Every call returns false once
+// writing to the file has failed.
+class ImageEncoder
+{
+	public:
+		virtual ~ImageEncoder() = default;
+
+		virtual bool Begin(std::FILE* file, int width, int height) = 0;
+		// A row of width pixels, three bytes each.
+		virtual bool WriteRow(const std::uint8_t* pixels) = 0;
+		// Finishes the file after the last row.
+		virtual bool End() = 0;
+
+		// The bytes written to the file since Begin.
+		std::uint64_t GetBytesWritten() const { return bytesWritten; }
+
+	protected:
+		std::FILE* file {nullptr};
+		int width {0};
+		int height {0};
+		std::uint64_t bytesWritten {0};
+		bool failed {false};
+
+		bool Write(const void* data, std::size_t size);
+};
+
+// Binary PPM (P6): a short text header followed by the raw rows.
+class PpmEncoder : public ImageEncoder
+{
+	public:
+		bool Begin(std::FILE* file, int width, int height) override;
+		bool WriteRow(const std::uint8_t* pixels) override;
+		bool End() override;
+};
+
+// PNG with the image data in stored (uncompressed) deflate blocks.
+// Compressing would cost far more than writing the bytes, and maze
+// images are meant to be written fast rather than small. Rows are
+// gathered into blocks of up to 64 KB, and every block is written
+// as its own IDAT chunk as soon as it is full.
+class PngEncoder : public ImageEncoder
+{
+	public:
+		bool Begin(std::FILE* file, int width, int height) override;
+		bool WriteRow(const std::uint8_t* pixels) override;
+		bool End() override;
+
+	private:
+		static constexpr std::size_t maxBlockSize = 65535;
+
+		std::vector<std::uint8_t> block;
+		std::uint32_t adler {1};
+		bool headerWritten {false};
+
+		void Append(const std::uint8_t* data, std::size_t size);
+		bool WriteChunk(const char* type, const std::uint8_t* data, std::size_t size);
+		bool FlushBlock(bool last);
+};
+
+#endif
@@ -0,0 +1,311 @@
+#include "IncrementalSolver.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+void IncrementalSolver::Reset(const Maze& maze)
+{
+	this->maze = &maze;
+	width = maze.GetWidth();
+	height = maze.GetHeight();
+	start = maze.GetIndex(maze.GetStartPosition());
+	exit = maze.GetIndex(maze.GetExitPosition());
+	exitPosition = maze.GetExitPosition();
+
+	std::size_t cellCount = static_cast<std::size_t>(width) * height;
+	open.resize(cellCount);
+
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++) {
+			open[static_cast<std::size_t>(y) * width + x] = !maze.HasTileAt(x, y, TileType::Wall);
+		}
+	}
+
+	repairBudget = cellCount / repairFraction;
+	frontier.reserve(cellCount);
+	distances.assign(cellCount, infinity);
+	expected.assign(cellCount, infinity);
+	openList.clear();
+	compactSize = minCompactSize;
+	path.clear();
+
+	expected[start] = 0;
+	openList.push_back({ GetKey(start, maze.GetStartPosition()), start });
+}
+
+// A changed tile changes the edges to its neighbours, so the expected
+// distance of the tile and of every neighbour is worked out again.
+void IncrementalSolver::NotifyChanged(GridPosition position)
+{
+	std::uint32_t index = maze->GetIndex(position);
+	open[index] = !maze->HasTileAt(position.x, position.y, TileType::Wall);
+
+	std::uint32_t neighbours[4];
+	int count = GetNeighbours(index, GetPosition(index), neighbours);
+
+	UpdateCell(index);
+
+	for (int i = 0; i < count; i++) {
+		UpdateCell(neighbours[i]);
+	}
+}
+
+// Expands cells in the order of their keys until the exit is settled
+// and no cell with a smaller key is left out of date.
+const std::vector<std::uint32_t>& IncrementalSolver::Solve()
+{
+	MAZE_PROFILE_SCOPE("SolveIncremental");
+
+	auto compare = std::greater<OpenEntry>();
+	nodesExpanded = 0;
+
+	while (!openList.empty())
+	{
+		OpenEntry top = openList.front();
+		std::uint32_t current = top.second;
+
+		if (IsOutOfDate(top) || distances[current] == expected[current])
+		{
+			std::pop_heap(openList.begin(), openList.end(), compare);
+			openList.pop_back();
+			continue;
+		}
+
+		if (top.first >= GetExitKey() && distances[exit] == expected[exit])
+			break;
+
+		// A change that moves a large part of the maze, such as a new
+		// shortcut, is repaired cell by cell at several times the cost
+		// of a breadth-first search over the whole maze.
+		if (nodesExpanded >= repairBudget)
+		{
+			Recompute();
+			break;
+		}
+
+		std::pop_heap(openList.begin(), openList.end(), compare);
+		openList.pop_back();
+		nodesExpanded++;
+
+		std::uint32_t neighbours[4];
+		int count = GetNeighbours(current, GetPosition(current), neighbours);
+
+		if (distances[current] > expected[current]) {
+			distances[current] = expected[current];
+		}
+		else
+		{
+			distances[current] = infinity;
+			UpdateCell(current);
+		}
+
+		for (int i = 0; i < count; i++) {
+			UpdateCell(neighbours[i]);
+		}
+	}
+
+	MAZE_PROFILE_COUNT("NodesExpanded", nodesExpanded);
+
+	if (openList.size() > compactSize) {
+		CompactOpenList();
+	}
+
+	BuildPath();
+	return path;
+}
+
+// The search stops once the exit is settled, which leaves every entry
+// keyed beyond the exit in the open list, and a cell is queued again
+// every time its key changes. Out of date and duplicate entries are
+// dropped once the list has doubled since it was last compacted.
+void IncrementalSolver::CompactOpenList()
+{
+	auto end = std::remove_if(openList.begin(), openList.end(), [this](const OpenEntry& entry)
+	{
+		return IsOutOfDate(entry) || distances[entry.second] == expected[entry.second];
+	});
+
+	std::sort(openList.begin(), end);
+	openList.erase(std::unique(openList.begin(), end), openList.end());
+	std::make_heap(openList.begin(), openList.end(), std::greater<OpenEntry>());
+
+	compactSize = std::max(minCompactSize, 2 * openList.size());
+}
+
+// Works out the distance of every cell from the start with a breadth-
+// first search. Every cell is then consistent, so nothing is left to
+// repair and the open list is emptied.
+void IncrementalSolver::Recompute()
+{
+	MAZE_PROFILE_SCOPE("RecomputeIncremental");
+
+	distances.assign(distances.size(), infinity);
+	openList.clear();
+	frontier.clear();
+
+	distances[start] = 0;
+	frontier.push_back(start);
+
+	for (std::size_t head = 0; head < frontier.size(); head++)
+	{
+		std::uint32_t current = frontier[head];
+		std::uint32_t neighbours[4];
+		int count = GetNeighbours(current, GetPosition(current), neighbours);
+
+		for (int i = 0; i < count; i++)
+		{
+			std::uint32_t neighbour = neighbours[i];
+
+			if (open[neighbour] && distances[neighbour] == infinity)
+			{
+				distances[neighbour] = distances[current] + 1;
+				frontier.push_back(neighbour);
+			}
+		}
+	}
+
+	expected = distances;
+	recomputes++;
+}
+
+// The position of a cell, with a single division, worked out once
+// for every cell that is expanded or updated and passed on.
+GridPosition IncrementalSolver::GetPosition(std::uint32_t index) const
+{
+	int y = static_cast<int>(index / static_cast<std::uint32_t>(width));
+	return { static_cast<int>(index) - y * width, y };
+}
+
+// Every neighbour inside the maze, walls included: a wall may have
+// just been a path, and its neighbours need to know.
+int IncrementalSolver::GetNeighbours(std::uint32_t index, GridPosition position, std::uint32_t* neighbours) const
+{
+	int count = 0;
+
+	if (position.y > 0) neighbours[count++] = index - width;
+	if (position.x < width - 1) neighbours[count++] = index + 1;
+	if (position.y < height - 1) neighbours[count++] = index + width;
+	if (position.x > 0) neighbours[count++] = index - 1;
+
+	return count;
+}
+
+// The Manhattan distance to the exit.
+std::uint32_t IncrementalSolver::GetHeuristic(GridPosition position) const
+{
+	return static_cast<std::uint32_t>(std::abs(position.x - exitPosition.x) + std::abs(position.y - exitPosition.y));
+}
+
+// The key orders cells by their estimated path length through the
+// cell first and by their distance from the start second. Cells with
+// an infinite distance sort last.
+std::uint64_t IncrementalSolver::GetKey(std::uint32_t index, GridPosition position) const
+{
+	std::uint32_t distance = std::min(distances[index], expected[index]);
+
+	if (distance == infinity)
+		return UINT64_MAX;
+
+	return (static_cast<std::uint64_t>(distance + GetHeuristic(position)) << 32) | distance;
+}
+
+// The heuristic of the exit is zero.
+std::uint64_t IncrementalSolver::GetExitKey() const
+{
+	std::uint32_t distance = std::min(distances[exit], expected[exit]);
+
+	if (distance == infinity)
+		return UINT64_MAX;
+
+	return (static_cast<std::uint64_t>(distance) << 32) | distance;
+}
+
+// The heuristic of a cell never changes, so an entry is up to date if
+// the distance in its low bits still is. An infinite key has all bits
+// set, which reads as an infinite distance.
+bool IncrementalSolver::IsOutOfDate(const OpenEntry& entry) const
+{
+	std::uint32_t index = entry.second;
+	return static_cast<std::uint32_t>(entry.first) != std::min(distances[index], expected[index]);
+}
+
+// Works out the distance a cell should have from its neighbours, and
+// queues the cell if that differs from the distance it has. Walls
+// cannot be reached at all.
+void IncrementalSolver::UpdateCell(std::uint32_t index)
+{
+	// A wall that nothing reached stays out of reach.
+	if (!open[index] && distances[index] == infinity && expected[index] == infinity)
+		return;
+
+	GridPosition position = GetPosition(index);
+
+	if (index != start)
+	{
+		std::uint32_t best = infinity;
+
+		if (open[index])
+		{
+			std::uint32_t neighbours[4];
+			int count = GetNeighbours(index, position, neighbours);
+
+			for (int i = 0; i < count; i++)
+			{
+				if (distances[neighbours[i]] != infinity && open[neighbours[i]]) {
+					best = std::min(best, distances[neighbours[i]] + 1);
+				}
+			}
+		}
+
+		expected[index] = best;
+	}
+
+	if (distances[index] != expected[index])
+	{
+		openList.push_back({ GetKey(index, position), index });
+		std::push_heap(openList.begin(), openList.end(), std::greater<OpenEntry>());
+	}
+}
+
+// Walks back from the exit, each time to the neighbour closest to the
+// start. The walk is bounded, in case the search was left incomplete.
+void IncrementalSolver::BuildPath()
+{
+	path.clear();
+
+	if (distances[exit] == infinity)
+		return;
+
+	std::uint32_t current = exit;
+	path.push_back(current);
+
+	while (current != start && path.size() <= distances[exit])
+	{
+		std::uint32_t neighbours[4];
+		int count = GetNeighbours(current, GetPosition(current), neighbours);
+		std::uint32_t closest = current;
+
+		for (int i = 0; i < count; i++)
+		{
+			if (open[neighbours[i]] && distances[neighbours[i]] < distances[closest]) {
+				closest = neighbours[i];
+			}
+		}
+
+		if (closest == current)
+			break;
+
+		current = closest;
+		path.push_back(current);
+	}
+
+	if (current != start)
+	{
+		path.clear();
+		return;
+	}
+
+	std::reverse(path.begin(), path.end());
+}
@@ -0,0 +1,83 @@
+#ifndef INCREMENTAL_SOLVER_H
+#define INCREMENTAL_SOLVER_H
+
+#include "Maze.h"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Keeps the shortest path of a maze up to date while its walls change,
+// with Lifelong Planning A*. The first solve is an ordinary A* search;
+// after that, only the cells whose distance from the start changed
+// because of the changed tiles are searched again. A change that moves
+// a large part of the maze costs more to repair cell by cell than to
+// search the whole maze again, so a repair that grows past a share of
+// the tiles starts over with a breadth-first search.
+class IncrementalSolver
+{
+	public:
+		static constexpr std::uint32_t infinity = 0xFFFFFFFF;
+		// A repair that expands more than this fraction of the tiles
+		// starts over with a breadth-first search instead.
+		static constexpr std::size_t repairFraction = 64;
+		// The open list is never compacted below this size.
+		static constexpr std::size_t minCompactSize = 1024;
+
+		// Starts over on the given maze, which must outlive the solver.
+		void Reset(const Maze& maze);
+
+		// Tells the solver that a tile changed between wall and path.
+		void NotifyChanged(GridPosition position);
+
+		// Repairs the search and returns the path from start to exit,
+		// or an empty path if the exit cannot be reached.
+		const std::vector<std::uint32_t>& Solve();
+
+		const std::vector<std::uint32_t>& GetPath() const { return path; }
+		// Cells expanded by the latest Solve.
+		std::uint64_t GetNodesExpanded() const { return nodesExpanded; }
+		// Repairs that started over with a breadth-first search.
+		std::uint64_t GetRecomputes() const { return recomputes; }
+
+	private:
+		// Entries of the open list: the key of a cell packed into the
+		// high bits and the cell in the low bits. Entries whose key is
+		// out of date are skipped when they reach the top.
+		typedef std::pair<std::uint64_t, std::uint32_t> OpenEntry;
+
+		const Maze* maze {nullptr};
+		int width {0};
+		int height {0};
+		std::uint32_t start {0};
+		std::uint32_t exit {0};
+		GridPosition exitPosition;
+
+		// Whether each cell is open, row by row like the cell indices,
+		// so that the search does not go through the tiles.
+		std::vector<std::uint8_t> open;
+		// The distance from the start found so far, and the one 
+		// expected from the neighbours.
+		std::vector<std::uint32_t> distances;
+		std::vector<std::uint32_t> expected;
+		std::vector<OpenEntry> openList;
+		std::size_t compactSize {minCompactSize};
+		std::vector<std::uint32_t> path;
+		std::vector<std::uint32_t> frontier;
+		std::uint64_t nodesExpanded {0};
+		std::uint64_t repairBudget {0};
+		std::uint64_t recomputes {0};
+
+		GridPosition GetPosition(std::uint32_t index) const;
+		int GetNeighbours(std::uint32_t index, GridPosition position, std::uint32_t* neighbours) const;
+		std::uint32_t GetHeuristic(GridPosition position) const;
+		std::uint64_t GetKey(std::uint32_t index, GridPosition position) const;
+		std::uint64_t GetExitKey() const;
+		bool IsOutOfDate(const OpenEntry& entry) const;
+		void UpdateCell(std::uint32_t index);
+		void CompactOpenList();
+		void Recompute();
+		void BuildPath();
+};
+
+#endif
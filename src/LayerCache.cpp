@@ -0,0 +1,84 @@
+#include "LayerCache.h"
+#include <algorithm>
+#include <cmath>
+
+void LayerCache::Reset(float width, float height)
+{
+	this->width = std::ceil(width);
+	this->height = std::ceil(height);
+	dirty.reserve(maxDirtyRegions);
+	regions.reserve(maxDirtyRegions);
+	Invalidate();
+}
+
+void LayerCache::Invalidate()
+{
+	valid = false;
+	dirty.clear();
+}
+
+void LayerCache::MarkDirty(const ViewRect& region)
+{
+	if (!valid)
+		return;
+
+	if (dirty.size() == maxDirtyRegions)
+	{
+		// Drawing the regions one by one would cost more than all at once.
+		Invalidate();
+		return;
+	}
+
+	dirty.push_back(region);
+}
+
+const std::vector<ViewRect>& LayerCache::Update(const ViewRect& view)
+{
+	regions.clear();
+
+	if (!valid || !Contains(view))
+	{
+		// The layer is kept on whole pixels, so that it is shown
+		// without any filtering.
+		bounds.left = std::floor(view.left + view.width * 0.5f - width * 0.5f);
+		bounds.top = std::floor(view.top + view.height * 0.5f - height * 0.5f);
+		bounds.width = width;
+		bounds.height = height;
+
+		valid = true;
+		dirty.clear();
+		regions.push_back(bounds);
+		fullRedraws++;
+		return regions;
+	}
+
+	for (const ViewRect& region : dirty)
+	{
+		// Clipped to the layer; regions outside of it are drawn when the layer moves.
+		float left = std::max(region.left, bounds.left);
+		float top = std::max(region.top, bounds.top);
+		float right = std::min(region.left + region.width, bounds.left + bounds.width);
+		float bottom = std::min(region.top + region.height, bounds.top + bounds.height);
+
+		if (right <= left || bottom <= top)
+			continue;
+
+		ViewRect clipped;
+		clipped.left = std::floor(left);
+		clipped.top = std::floor(top);
+		clipped.width = std::ceil(right) - clipped.left;
+		clipped.height = std::ceil(bottom) - clipped.top;
+		regions.push_back(clipped);
+	}
+
+	dirty.clear();
+	regionRedraws += regions.size();
+	return regions;
+}
+
+bool LayerCache::Contains(const ViewRect& view) const
+{
+	return view.left >= bounds.left && view.top >= bounds.top &&
+	       view.left + view.width <= bounds.left + bounds.width &&
+	       view.top + view.height <= bounds.top + bounds.height;
+}
@@ -0,0 +1,58 @@
+#ifndef LAYER_CACHE_H
+#define LAYER_CACHE_H
+
+#include "TileBatch.h"
+#include <vector>
+#include <cstddef>
+
+// Keeps track of an image of the static part of the world that is
+// rendered once and then reused every frame: which area of the world
+// it covers and which regions of it are out of date. The image covers
+// more than the view, so the camera can move for a while before it has
+// to be rendered again. Rendering is left to the caller, which only
+// needs to redraw the regions returned by Update.
+class LayerCache
+{
+	public:
+		// Beyond this many dirty regions, the whole layer is redrawn.
+		static constexpr std::size_t maxDirtyRegions = 64;
+
+		// The size of the layer in pixels. Drops whatever was rendered.
+		void Reset(float width, float height);
+
+		// The whole layer is out of date, e.g. after the world changed.
+		void Invalidate();
+
+		// Part of the world changed; the region is redrawn if it is within the layer.
+		void MarkDirty(const ViewRect& region);
+
+		// Decides what to redraw before the layer is shown in the view.
+		// If the view is not within the layer, the layer is moved to be
+		// centered on it and the whole of it is returned. Otherwise the
+		// dirty regions within the layer are returned, which is nothing
+		// at all while the world does not change. Either way, the layer
+		// is up to date once the regions are redrawn.
+		const std::vector<ViewRect>& Update(const ViewRect& view);
+
+		// The area of the world covered by the layer, in whole pixels.
+		const ViewRect& GetBounds() const { return bounds; }
+		bool IsValid() const { return valid; }
+
+		// Counts of the work done, for the stats.
+		std::size_t GetFullRedraws() const { return fullRedraws; }
+		std::size_t GetRegionRedraws() const { return regionRedraws; }
+
+	private:
+		float width {0.0f};
+		float height {0.0f};
+		ViewRect bounds;
+		bool valid {false};
+		std::vector<ViewRect> dirty;
+		std::vector<ViewRect> regions;
+		std::size_t fullRedraws {0};
+		std::size_t regionRedraws {0};
+
+		bool Contains(const ViewRect& view) const;
+};
+
+#endif
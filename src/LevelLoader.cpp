@@ -0,0 +1,107 @@
+#include "LevelLoader.h"
+#include <chrono>
+
+LevelLoader::LevelLoader(int size, float tileSize, std::uint64_t seed)
+	: generator(seed), size(size), tileSize(tileSize)
+{
+	worker = std::thread(&LevelLoader::Run, this);
+}
+
+LevelLoader::~LevelLoader()
+{
+	stopping = true;
+	wakeUp.notify_one();
+	worker.join();
+
+	delete ready.exchange(nullptr);
+	delete retired.exchange(nullptr);
+}
+
+std::unique_ptr<Level> LevelLoader::TakeNext()
+{
+	Level* level = ready.exchange(nullptr, std::memory_order_acquire);
+
+	if (level != nullptr) {
+		wakeUp.notify_one();
+	}
+
+	return std::unique_ptr<Level>(level);
+}
+
+std::unique_ptr<Level> LevelLoader::WaitForNext()
+{
+	std::unique_ptr<Level> level = TakeNext();
+
+	while (!level)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		level = TakeNext();
+	}
+
+	return level;
+}
+
+void LevelLoader::Retire(std::unique_ptr<Level> level)
+{
+	// Only one level is retired per level played, so the slot is
+	// practically always empty. If not, the old one is dropped here.
+	delete retired.exchange(level.release(), std::memory_order_acq_rel);
+	wakeUp.notify_one();
+}
+
+// Keeps one finished level ready and keeps a retired level for reuse.
+// The game thread never takes the mutex: notifications may be missed,
+// so the worker also wakes up on its own every few milliseconds.
+void LevelLoader::Run()
+{
+	while (!stopping)
+	{
+		if (Level* level = retired.exchange(nullptr, std::memory_order_acq_rel)) {
+			recycled.reset(level);
+		}
+
+		if (ready.load(std::memory_order_acquire) == nullptr)
+		{
+			ready.store(CreateLevel(std::move(recycled)).release(), std::memory_order_release);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(mutex);
+		wakeUp.wait_for(lock, std::chrono::milliseconds(5));
+	}
+}
+
+// A retired level is regenerated in place if its view holds the only
+// other reference to its maze; otherwise a new level is made.
+std::unique_ptr<Level> LevelLoader::CreateLevel(std::unique_ptr<Level> level)
+{
+	using namespace std::chrono;
+	auto begin = steady_clock::now();
+
+	bool reuse = level && level->view && level->maze.use_count() == 2;
+
+	if (!reuse) {
+		level = std::make_unique<Level>();
+	}
+
+	level->stats = ProfileStats();
+	ProfileStatsScope statsScope(level->stats);
+	MAZE_PROFILE_SCOPE("CreateLevel");
+
+	if (reuse)
+	{
+		generator.Create(size, size, *level->maze);
+		level->maze->Solve();
+		level->view->Rebuild();
+	}
+	else
+	{
+		level->maze = generator.Create(size, size);
+		level->maze->Solve();
+		level->view = std::make_unique<MazeView>(level->maze, tileSize);
+	}
+
+	level->generationNanoseconds = duration_cast<nanoseconds>(steady_clock::now() - begin).count();
+
+	return level;
+}
@@ -0,0 +1,68 @@
+#ifndef LEVEL_LOADER_H
+#define LEVEL_LOADER_H
+
+#include "MazeGenerator.h"
+#include "MazeView.h"
+#include "Profiler.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// A generated, solved and drawable level.
+struct Level
+{
+	std::shared_ptr<Maze> maze;
+	std::unique_ptr<MazeView> view;
+	// Time spent generating, solving and building the view.
+	std::uint64_t generationNanoseconds {0};
+	// Timings of the phases of generation, when profiling is compiled in.
+	ProfileStats stats;
+};
+
+// Generates levels on a background thread, always one level ahead,
+// so that the game never waits for the generator. The finished level
+// is handed over through an atomic pointer: taking it never locks and
+// never blocks the frame. Retired levels are regenerated in place, so
+// after the first two levels, no level allocates memory.
+class LevelLoader
+{
+	public:
+		LevelLoader(int size, float tileSize, std::uint64_t seed);
+		~LevelLoader();
+
+		LevelLoader(const LevelLoader&) = delete;
+		LevelLoader& operator=(const LevelLoader&) = delete;
+
+		// Returns the next level if it is ready, otherwise nullptr.
+		std::unique_ptr<Level> TakeNext();
+
+		// Blocks until the next level is ready. Meant for the first level.
+		std::unique_ptr<Level> WaitForNext();
+
+		// Hands a finished level back, so that it is recycled or destroyed
+		// on the background thread instead of during a frame.
+		void Retire(std::unique_ptr<Level> level);
+
+	private:
+		MazeGenerator generator;
+		int size;
+		float tileSize;
+
+		std::atomic<Level*> ready {nullptr};
+		std::atomic<Level*> retired {nullptr};
+		std::atomic<bool> stopping {false};
+		// A retired level waiting to be regenerated. Only the worker uses it.
+		std::unique_ptr<Level> recycled;
+
+		std::mutex mutex;
+		std::condition_variable wakeUp;
+		std::thread worker;
+
+		void Run();
+		std::unique_ptr<Level> CreateLevel(std::unique_ptr<Level> level);
+};
+
+#endif
@@ -1,41 +1,158 @@
 #include <SFML\Graphics.hpp>
-#include "MazeGenerator.h"
+#include "LevelLoader.h"
 #include "Application.h"
 #include "Player.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
 #include <Windows.h>
+#include <chrono>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+
+// Frames are drawn at up to this rate; the simulation steps at its own.
+static const int updatesPerSecond = 24;
+// After a long frame, at most this many steps catch up. Beyond that the
+// time is dropped, rather than fast-forwarding the player.
+static const int maxUpdatesPerFrame = 4;
+
+// The given percentile (0-100) of the frame times. Reorders them.
+static std::int64_t GetPercentile(std::vector<std::int64_t>& frameTimes, double percentile)
+{
+	if (frameTimes.empty())
+		return 0;
+
+	auto nth = frameTimes.begin() + static_cast<std::ptrdiff_t>((frameTimes.size() - 1) * percentile / 100.0);
+	std::nth_element(frameTimes.begin(), nth, frameTimes.end());
+	return *nth;
+}
+
+// Shows how long the current level took to generate, next to the
+// frame times of the previous level. Generation runs in the
+// background, so the two are measured and reported separately.
+static std::string FormatTitle(const Level& level, std::vector<std::int64_t>& frameTimes)
+{
+	std::ostringstream title;
+	title << "Maze Generator - level generated in " 
+	      << level.generationNanoseconds / 1000000.0 << " ms, frames median " 
+	      << GetPercentile(frameTimes, 50.0) / 1000000.0 << " ms, 99% " 
+	      << GetPercentile(frameTimes, 99.0) / 1000000.0 << " ms, longest "
+	      << GetPercentile(frameTimes, 100.0) / 1000000.0 << " ms";
+
+#ifdef MAZE_ENABLE_PROFILING
+	for (const ProfileStats::Entry& entry : level.stats) {
+		title << ", " << entry.name << " " << entry.nanoseconds / 1000000.0 << " ms";
+	}
+#endif
+
+	return title.str();
+}
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR szCmdLine, int iCmdShow)
 {
 	int width = 640; int height = 640; 
-	int size = 21;
+	int size = 101;
+	// Tiles keep their size in pixels; the camera follows the player.
+	float tileSize = 32.0f;
 	Application application(width, height);
 
-	MazeGenerator mazeGenerator;
-	std::shared_ptr<Maze> maze = mazeGenerator.Create(size, size, width, height);
+	auto time = std::chrono::system_clock::now().time_since_epoch();
+	LevelLoader levelLoader(size, tileSize, static_cast<std::uint64_t>(time.count()));
+	std::unique_ptr<Level> level = levelLoader.WaitForNext();
 
-	sf::Vector2f playerSize = { static_cast<float>(width) / size, 
-		                    static_cast<float>(height) / size };
+	sf::Vector2f playerSize = { tileSize, tileSize };
 
-	Player player(playerSize, maze);
+	Player player(playerSize, level->maze);
 	player.GotoStart();
 
-	maze->Solve();
+	// The CPU time of every frame of the current level.
+	std::vector<std::int64_t> frameTimes;
+	frameTimes.reserve(1 << 16);
+	application.SetTitle(FormatTitle(*level, frameTimes));
+
+#ifdef MAZE_ENABLE_PROFILING
+	// F3 shows how the latest frames were spent. The trace of the whole
+	// session is written next to the executable on exit.
+	Profiler::SetTracing(true);
+	ProfilerOverlay overlay({ 8.0f, 8.0f }, 1000.0f / 60.0f);
+	bool showOverlay = false;
+	bool overlayKeyDown = false;
+#endif
+
+	// The player moves at most one tile per step, however often the maze is drawn.
+	const auto updateStep = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::nanoseconds(1000000000 / updatesPerSecond));
+	auto previousFrame = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::duration lag(0);
 
 	while (application.Run())
 	{
-		player.Update();
-		if (player.IsAtExit())
+		MAZE_PROFILE_FRAME(FrameStage::Input);
+		auto frameBegin = std::chrono::steady_clock::now();
+		lag += frameBegin - previousFrame;
+		previousFrame = frameBegin;
+
+		for (int step = 0; lag >= updateStep; step++)
 		{
-			maze = mazeGenerator.Create(size, size, width, height);
-			player.SetMaze(maze);
-			player.GotoStart();
-			maze->Solve();
+			if (step == maxUpdatesPerFrame)
+			{
+				lag = std::chrono::steady_clock::duration(0);
+				break;
+			}
+
+			lag -= updateStep;
+			player.Update();
+
+			// The next level is generated in the background. If it is not
+			// ready yet, the player stays at the exit of the current level
+			// and the swap happens on the first step it is.
+			if (player.IsAtExit())
+			{
+				if (std::unique_ptr<Level> nextLevel = levelLoader.TakeNext())
+				{
+					player.SetMaze(nextLevel->maze);
+					player.GotoStart();
+					levelLoader.Retire(std::move(level));
+					level = std::move(nextLevel);
+
+					application.SetTitle(FormatTitle(*level, frameTimes));
+					frameTimes.clear();
+				}
+			}
 		}
 
-		application.Draw(*maze);
+		MAZE_PROFILE_FRAME(FrameStage::Update);
+
+		application.SetCamera(player.GetCenter());
+		application.Draw(*level->view);
 		application.Draw(player);
+
+#ifdef MAZE_ENABLE_PROFILING
+		bool keyDown = sf::Keyboard::isKeyPressed(sf::Keyboard::F3);
+		showOverlay ^= keyDown && !overlayKeyDown;
+		overlayKeyDown = keyDown;
+
+		if (showOverlay)
+		{
+			overlay.Update(Profiler::GetFrameStats());
+			application.DrawOnScreen(overlay);
+		}
+#endif
+
+		MAZE_PROFILE_FRAME(FrameStage::Draw);
+
+		// Frame time excludes the wait for the frame rate limit,
+		// which happens inside Display.
+		auto frameTime = std::chrono::steady_clock::now() - frameBegin;
+		frameTimes.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(frameTime).count());
+
 		application.Display();
+		MAZE_PROFILE_FRAME(FrameStage::Display);
 	}
 
+#ifdef MAZE_ENABLE_PROFILING
+	Profiler::WriteChromeTrace("maze-trace.json");
+#endif
+
 	return 0;
 }
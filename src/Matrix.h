@@ -2,38 +2,164 @@
 #define MATRIX_H
 
 #include <vector>
-#include <iostream>
+#include <algorithm>
+#include <cstddef>
 
-template <class T>
-// A structure for holding a vector of vectors (2D array / a grid).
-struct Matrix
-{	
-	std::vector<std::vector<T>> cells;
+// Layouts decide where a cell of a Matrix is stored in its buffer.
+// Every layout is constructed from the dimensions of the grid and
+// tells how many cells the buffer must hold (blocked layouts pad
+// the grid up to whole blocks).
 
-	Matrix() { };
+// Cells of the same column are adjacent: [x][y] is next to [x][y + 1].
+struct ColumnMajor
+{
+	ColumnMajor() { }
+	ColumnMajor(int width, int height) : width(width), height(height) { }
+
+	std::size_t GetSize() const
+	{
+		return static_cast<std::size_t>(width) * height;
+	}
+
+	std::size_t Index(int x, int y) const
+	{
+		return static_cast<std::size_t>(x) * height + y;
+	}
+
+	private:
+		int width {0};
+		int height {0};
+};
+
+// Cells of the same row are adjacent: [x][y] is next to [x + 1][y].
+struct RowMajor
+{
+	RowMajor() { }
+	RowMajor(int width, int height) : width(width), height(height) { }
+
+	std::size_t GetSize() const
+	{
+		return static_cast<std::size_t>(width) * height;
+	}
+
+	std::size_t Index(int x, int y) const
+	{
+		return static_cast<std::size_t>(y) * width + x;
+	}
+
+	private:
+		int width {0};
+		int height {0};
+};
+
+// The grid is split into square blocks of BlockSize x BlockSize cells,
+// each stored contiguously (row-major inside the block). Neighbours in
+// every direction are then most likely in the same cache lines.
+template <int BlockSize = 8>
+struct Blocked
+{
+	static_assert((BlockSize & (BlockSize - 1)) == 0, "BlockSize must be a power of two");
+
+	Blocked() { }
+	Blocked(int width, int height) : blocksX((width + BlockSize - 1) / BlockSize),
+	                                 blocksY((height + BlockSize - 1) / BlockSize) { }
+
+	std::size_t GetSize() const
+	{
+		return static_cast<std::size_t>(blocksX) * blocksY * BlockSize * BlockSize;
+	}
+
+	std::size_t Index(int x, int y) const
+	{
+		std::size_t block = static_cast<std::size_t>(y / BlockSize) * blocksX + x / BlockSize;
+		return block * (BlockSize * BlockSize) + (y % BlockSize) * BlockSize + (x % BlockSize);
+	}
+
+	private:
+		int blocksX {0};
+		int blocksY {0};
+};
 
-	Matrix(int height, int width)
+// A grid of cells stored in a single contiguous buffer. Cells are
+// accessed as matrix[x][y] or matrix(x, y); how they are laid out in
+// memory is decided by the Layout policy.
+template <class T, class Layout = ColumnMajor>
+struct Matrix
+{
+	typedef typename std::vector<T>::reference Reference;
+	typedef typename std::vector<T>::const_reference ConstReference;
+
+	// A single column of the matrix, returned by operator[] so that
+	// the familiar matrix[x][y] syntax keeps working.
+	template <class MatrixType, class ReferenceType>
+	struct Column
 	{
-		for (int x = 0; x < width; x++)
+		MatrixType& matrix;
+		int x;
+
+		ReferenceType operator[](int y) const
 		{
-			std::vector<T> line = std::vector<T>();
-			line.resize(height);
-			cells.push_back(line);
+			return matrix(x, y);
 		}
+	};
+
+	std::vector<T> cells;
+
+	Matrix() { };
+
+	Matrix(int width, int height, const T& value = T())
+		: cells(Layout(width, height).GetSize(), value),
+		  layout(width, height), width(width), height(height) { }
+
+	int GetWidth() const { return width; }
+	int GetHeight() const { return height; }
+	const Layout& GetLayout() const { return layout; }
+
+	ConstReference operator()(int x, int y) const
+	{
+		return cells[layout.Index(x, y)];
+	}
+
+	Reference operator()(int x, int y)
+	{
+		return cells[layout.Index(x, y)];
+	}
+
+	Column<const Matrix, ConstReference> operator[](int x) const
+	{
+		return { *this, x };
+	}
+
+	Column<Matrix, Reference> operator[](int x)
+	{
+		return { *this, x };
 	}
 
-	int GetWidth() const { return cells.size(); }
-	int GetHeight() const { return cells[0].size(); }
-	
-	const std::vector<T>& operator[](int index) const
+	// Raw access to the buffer for bulk operations. Cells are in
+	// layout order, padding included.
+	T* data() { return cells.data(); }
+	const T* data() const { return cells.data(); }
+	std::size_t size() const { return cells.size(); }
+
+	void Fill(const T& value)
 	{
-		return cells[index];
+		std::fill(cells.begin(), cells.end(), value);
 	}
 
-	std::vector<T>& operator[](int index)
+	// Gives the matrix new dimensions and fills it with a value. The
+	// buffer is only reallocated if it has to grow.
+	void Reset(int width, int height, const T& value = T())
 	{
-		return cells[index];
+		layout = Layout(width, height);
+		cells.assign(layout.GetSize(), value);
+		this->width = width;
+		this->height = height;
 	}
+
+	private:
+		Layout layout;
+		int width {0};
+		int height {0};
 };
 
-#endif
\ No newline at end of file
+#endif
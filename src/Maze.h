@@ -1,34 +1,88 @@
 #ifndef MAZE_H
 #define MAZE_H
 
-#include "Tile.h"
+#include "Grid.h"
 #include "Matrix.h"
-#include <stack>
+#include "MazeSolver.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
 
-class Maze : public sf::Drawable
+// The maze itself: a compact grid of tile types together with
+// the start and exit positions. Does not depend on SFML, so mazes
+// can be generated and solved without a display. A maze is never
+// copied: the grid is moved in, and a maze can be reset with a new
+// grid, keeping the memory of its solution and solver.
+class Maze
 {
 	public:
-		Maze(Matrix<Tile>& tiles, 
-			std::vector<sf::Vertex>& wallVertices, 
-			sf::Vector2i startPosition) : tiles(tiles), 
-			                              wallVertices(wallVertices),
-						      startPosition(startPosition) { }
-
-		bool HasTileAt(int gridX, int gridY, TileType type);
-		sf::Vector2i GetStartPosition() const { return startPosition; }
+		Maze(Matrix<TileType> tiles, 
+			GridPosition startPosition,
+			GridPosition exitPosition,
+			std::uint64_t seed = 0) : tiles(std::move(tiles)), 
+			                          startPosition(startPosition),
+			                          exitPosition(exitPosition),
+			                          seed(seed) { }
+
+		Maze(const Maze&) = delete;
+		Maze& operator=(const Maze&) = delete;
+		Maze(Maze&&) = default;
+		Maze& operator=(Maze&&) = default;
+
+		// Replaces the grid with the next level and clears the solution.
+		void Reset(Matrix<TileType> tiles, GridPosition startPosition, 
+		           GridPosition exitPosition, std::uint64_t seed = 0);
+
+		// Moves the grid out, so that its buffer can be filled with another
+		// maze. The maze is empty until it is reset.
+		Matrix<TileType> ReleaseTiles()
+		{
+			Matrix<TileType> released = std::move(tiles);
+			tiles = Matrix<TileType>();
+			return released;
+		}
+
+		bool HasTileAt(int gridX, int gridY, TileType type) const;
+
+		// Turns a wall into a path, or a path into a wall. The start and
+		// the exit cannot be changed. Returns true if the tile changed;
+		// the solution is left as it was.
+		bool OpenCell(GridPosition position);
+		bool CloseCell(GridPosition position);
+		int GetWidth() const { return tiles.GetWidth(); }
+		int GetHeight() const { return tiles.GetHeight(); }
+		const Matrix<TileType>& GetTiles() const { return tiles; }
+		GridPosition GetStartPosition() const { return startPosition; }
+		GridPosition GetExitPosition() const { return exitPosition; }
+		std::uint64_t GetSeed() const { return seed; }
+
+		// Cells are identified by their index y * width + x.
+		std::uint32_t GetIndex(GridPosition position) const
+		{
+			return static_cast<std::uint32_t>(position.y) * GetWidth() + position.x;
+		}
+
+		GridPosition GetPosition(std::uint32_t index) const
+		{
+			return { static_cast<int>(index % GetWidth()), 
+			         static_cast<int>(index / GetWidth()) };
+		}
+
+		// The cells from start to exit found by the latest Solve().
+		const std::vector<std::uint32_t>& GetSolution() const { return solution; }
 		void Solve();
-		void Traverse();
-		bool FindUnvisitedTile(sf::Vector2i currentPosition);
-		bool FindExit(sf::Vector2i currentPosition, sf::Vector2i& outExit);
+		void Solve(MazeSolver& solver);
 
-	private:
-		Matrix<Tile> tiles;
-		Matrix<bool> visitedTiles;
-		std::stack<sf::Vector2i> tileStack;
-		std::vector<sf::Vertex> wallVertices;
-		sf::Vector2i startPosition;
+		// Replaces the solution, e.g. with one loaded from a file.
+		void SetSolution(std::vector<std::uint32_t> path) { solution = std::move(path); }
 
-		virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+	private:
+		Matrix<TileType> tiles;
+		MazeSolver solver;
+		std::vector<std::uint32_t> solution;
+		GridPosition startPosition;
+		GridPosition exitPosition;
+		std::uint64_t seed;
 };
 
 #endif
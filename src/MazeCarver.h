@@ -0,0 +1,32 @@
+#ifndef MAZE_CARVER_H
+#define MAZE_CARVER_H
+
+#include "Grid.h"
+#include "Matrix.h"
+#include "Random.h"
+
+// A rectangle of the odd-coordinate lattice that carving is limited to.
+// The coordinates are those of the first and last odd tiles, inclusive.
+struct CarveBounds
+{
+	int minX {1};
+	int minY {1};
+	int maxX {1};
+	int maxY {1};
+};
+
+// An algorithm that carves a spanning tree through the lattice cells of
+// a rectangle of walls, which makes a perfect maze of it. MazeGenerator
+// carves with a DepthFirstCarver unless it is given another one.
+class MazeCarver
+{
+	public:
+		virtual ~MazeCarver() { }
+
+		// Only tiles within the bounds are written. The start position
+		// is where the player starts; carvers may start from it.
+		virtual void Carve(Matrix<TileType>& tiles, RandomEngine& random,
+		                   GridPosition startPosition, CarveBounds bounds) = 0;
+};
+
+#endif
@@ -0,0 +1,392 @@
+#include "MazeFile.h"
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char magic[4] = { 'M', 'A', 'Z', 'E' };
+static const std::uint16_t hasSolutionFlag = 1;
+
+// Mixes 64-bit words into a checksum. Files are always padded to whole words.
+static std::uint64_t Checksum(const std::uint64_t* words, std::size_t count, std::uint64_t hash)
+{
+	for (std::size_t i = 0; i < count; i++)
+	{
+		hash ^= words[i] * 0x9E3779B97F4A7C15ull;
+		hash = ((hash << 31) | (hash >> 33)) * 0xBF58476D1CE4E5B9ull;
+	}
+
+	return hash;
+}
+
+static const std::uint64_t checksumSeed = 0x243F6A8885A308D3ull;
+
+template <class T>
+static void Store(unsigned char* header, std::size_t offset, T value)
+{
+	std::memcpy(header + offset, &value, sizeof(T));
+}
+
+template <class T>
+static T Load(const unsigned char* header, std::size_t offset)
+{
+	T value;
+	std::memcpy(&value, header + offset, sizeof(T));
+	return value;
+}
+
+static std::size_t GetWordsPerRow(int width)
+{
+	return (static_cast<std::size_t>(width) + 63) / 64;
+}
+
+// The whole grid is packed before writing. The maze is stored column
+// by column, so it is read that way and bits are scattered into rows.
+bool MazeFile::Write(const Maze& maze, const char* path, bool includeSolution)
+{
+	int width = maze.GetWidth();
+	int height = maze.GetHeight();
+	std::size_t wordsPerRow = GetWordsPerRow(width);
+
+	std::vector<std::uint64_t> words(wordsPerRow * height);
+	const Matrix<TileType>& tiles = maze.GetTiles();
+
+	for (int x = 0; x < width; x++)
+	{
+		std::uint64_t bit = std::uint64_t(1) << (x & 63);
+		std::uint64_t* word = &words[x >> 6];
+
+		for (int y = 0; y < height; y++, word += wordsPerRow)
+		{
+			if (tiles[x][y] == TileType::Wall) {
+				*word |= bit;
+			}
+		}
+	}
+
+	const std::vector<std::uint32_t>& solution = maze.GetSolution();
+	bool hasSolution = includeSolution && !solution.empty();
+
+	if (hasSolution)
+	{
+		// The solution is padded to whole words.
+		std::size_t first = words.size();
+		words.resize(first + (solution.size() + 1) / 2);
+		std::memcpy(&words[first], solution.data(), solution.size() * sizeof(std::uint32_t));
+	}
+
+	unsigned char header[MazeFile::headerSize] = {};
+	std::memcpy(header, magic, sizeof(magic));
+	Store<std::uint16_t>(header, 4, MazeFile::version);
+	Store<std::uint16_t>(header, 6, hasSolution ? hasSolutionFlag : 0);
+	Store<std::uint32_t>(header, 8, width);
+	Store<std::uint32_t>(header, 12, height);
+	Store<std::uint64_t>(header, 16, maze.GetSeed());
+	Store<std::uint32_t>(header, 24, maze.GetStartPosition().x);
+	Store<std::uint32_t>(header, 28, maze.GetStartPosition().y);
+	Store<std::uint32_t>(header, 32, maze.GetExitPosition().x);
+	Store<std::uint32_t>(header, 36, maze.GetExitPosition().y);
+	Store<std::uint32_t>(header, 40, hasSolution ? static_cast<std::uint32_t>(solution.size()) : 0);
+	Store<std::uint32_t>(header, 44, static_cast<std::uint32_t>(wordsPerRow));
+	Store<std::uint64_t>(header, 48, Checksum(words.data(), words.size(), checksumSeed));
+
+	std::FILE* file = std::fopen(path, "wb");
+
+	if (file == nullptr)
+		return false;
+
+	bool written = std::fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+		       std::fwrite(words.data(), sizeof(std::uint64_t), words.size(), file) == words.size();
+
+	return std::fclose(file) == 0 && written;
+}
+
+std::size_t MazeFile::GetFileSize(const Maze& maze, bool includeSolution)
+{
+	std::size_t gridWords = GetWordsPerRow(maze.GetWidth()) * maze.GetHeight();
+	std::size_t solutionWords = includeSolution ? (maze.GetSolution().size() + 1) / 2 : 0;
+
+	return MazeFile::headerSize + (gridWords + solutionWords) * sizeof(std::uint64_t);
+}
+
+bool MazeFile::WriteText(const Maze& maze, std::FILE* file, std::vector<char>& lines)
+{
+	const Matrix<TileType>& tiles = maze.GetTiles();
+	GridPosition start = maze.GetStartPosition();
+	GridPosition exit = maze.GetExitPosition();
+
+	std::fprintf(file, "maze %llu %d %d start %d %d exit %d %d path %zu\n",
+	             static_cast<unsigned long long>(maze.GetSeed()), maze.GetWidth(), maze.GetHeight(),
+	             start.x, start.y, exit.x, exit.y, maze.GetSolution().size());
+
+	lines.resize(static_cast<std::size_t>(maze.GetWidth() + 1) * maze.GetHeight());
+
+	for (int y = 0; y < maze.GetHeight(); y++)
+	{
+		char* line = &lines[static_cast<std::size_t>(y) * (maze.GetWidth() + 1)];
+
+		for (int x = 0; x < maze.GetWidth(); x++)
+		{
+			TileType type = tiles(x, y);
+			line[x] = (type == TileType::Wall) ? '#' : (type == TileType::Exit) ? 'E' : ' ';
+		}
+
+		line[maze.GetWidth()] = '\n';
+	}
+
+	for (std::uint32_t index : maze.GetSolution())
+	{
+		GridPosition position = maze.GetPosition(index);
+
+		if (tiles(position.x, position.y) == TileType::Path) {
+			lines[static_cast<std::size_t>(position.y) * (maze.GetWidth() + 1) + position.x] = '.';
+		}
+	}
+
+	return std::fwrite(lines.data(), 1, lines.size(), file) == lines.size();
+}
+
+std::unique_ptr<Maze> MazeFile::ReadText(std::FILE* file)
+{
+	unsigned long long seed;
+	int width;
+	int height;
+	GridPosition start;
+	GridPosition exit;
+	std::size_t pathLength;
+
+	if (std::fscanf(file, "maze %llu %d %d start %d %d exit %d %d path %zu", &seed, &width, &height,
+	                &start.x, &start.y, &exit.x, &exit.y, &pathLength) != 8 || std::fgetc(file) != '\n')
+		return nullptr;
+
+	if (width <= 0 || height <= 0 || static_cast<std::uint64_t>(width) * height > UINT32_MAX)
+		return nullptr;
+
+	Matrix<TileType> tiles(width, height, TileType::Wall);
+	std::vector<char> line(static_cast<std::size_t>(width) + 1);
+
+	for (int y = 0; y < height; y++)
+	{
+		if (std::fread(line.data(), 1, line.size(), file) != line.size() || line[width] != '\n')
+			return nullptr;
+
+		for (int x = 0; x < width; x++)
+		{
+			char tile = line[x];
+			tiles(x, y) = (tile == '#') ? TileType::Wall : (tile == 'E') ? TileType::Exit : TileType::Path;
+		}
+	}
+
+	if (start.x < 0 || start.x >= width || start.y < 0 || start.y >= height ||
+	    exit.x < 0 || exit.x >= width || exit.y < 0 || exit.y >= height)
+		return nullptr;
+
+	return std::make_unique<Maze>(std::move(tiles), start, exit, seed);
+}
+
+MappedMaze::~MappedMaze()
+{
+	Close();
+}
+
+bool MappedMaze::Open(const char* path)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, 
+				  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	HANDLE mapping = nullptr;
+
+	if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	fileHandle = file;
+	mappingHandle = mapping;
+
+	if (data == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	fileSize = static_cast<std::size_t>(size.QuadPart);
+#else
+	int file = open(path, O_RDONLY);
+
+	if (file < 0)
+		return false;
+
+	struct stat status;
+
+	if (fstat(file, &status) != 0 || status.st_size <= 0)
+	{
+		close(file);
+		return false;
+	}
+
+	void* mapped = mmap(nullptr, status.st_size, PROT_READ, MAP_SHARED, file, 0);
+	close(file);
+
+	if (mapped == MAP_FAILED)
+		return false;
+
+	data = static_cast<const unsigned char*>(mapped);
+	fileSize = static_cast<std::size_t>(status.st_size);
+#endif
+
+	if (fileSize < MazeFile::headerSize || std::memcmp(data, magic, sizeof(magic)) != 0 ||
+	    Load<std::uint16_t>(data, 4) != MazeFile::version)
+	{
+		Close();
+		return false;
+	}
+
+	width = static_cast<int>(Load<std::uint32_t>(data, 8));
+	height = static_cast<int>(Load<std::uint32_t>(data, 12));
+	seed = Load<std::uint64_t>(data, 16);
+	startPosition = { static_cast<int>(Load<std::uint32_t>(data, 24)), 
+			  static_cast<int>(Load<std::uint32_t>(data, 28)) };
+	exitPosition = { static_cast<int>(Load<std::uint32_t>(data, 32)), 
+			 static_cast<int>(Load<std::uint32_t>(data, 36)) };
+	solutionLength = Load<std::uint32_t>(data, 40);
+	wordsPerRow = Load<std::uint32_t>(data, 44);
+	checksum = Load<std::uint64_t>(data, 48);
+
+	bool hasSolution = (Load<std::uint16_t>(data, 6) & hasSolutionFlag) != 0;
+	std::size_t gridWords = wordsPerRow * height;
+	std::size_t solutionWords = hasSolution ? (solutionLength + 1) / 2 : 0;
+
+	if (width <= 0 || height <= 0 || static_cast<std::uint64_t>(width) * height > UINT32_MAX ||
+	    wordsPerRow != GetWordsPerRow(width) || !IsInside(startPosition) || !IsInside(exitPosition) ||
+	    fileSize != MazeFile::headerSize + (gridWords + solutionWords) * sizeof(std::uint64_t))
+	{
+		Close();
+		return false;
+	}
+
+	grid = reinterpret_cast<const std::uint64_t*>(data + MazeFile::headerSize);
+	solution = hasSolution ? reinterpret_cast<const std::uint32_t*>(grid + gridWords) : nullptr;
+
+	if (!hasSolution) {
+		solutionLength = 0;
+	}
+
+	// The solution is short next to the grid, and every user of it
+	// indexes the grid with it.
+	std::uint32_t cellCount = static_cast<std::uint32_t>(width * height);
+
+	for (std::size_t i = 0; i < solutionLength; i++)
+	{
+		if (solution[i] >= cellCount)
+		{
+			Close();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void MappedMaze::Close()
+{
+#ifdef _WIN32
+	if (data != nullptr) {
+		UnmapViewOfFile(data);
+	}
+
+	if (mappingHandle != nullptr) {
+		CloseHandle(mappingHandle);
+	}
+
+	if (fileHandle != nullptr) {
+		CloseHandle(fileHandle);
+	}
+
+	fileHandle = nullptr;
+	mappingHandle = nullptr;
+#else
+	if (data != nullptr) {
+		munmap(const_cast<unsigned char*>(data), fileSize);
+	}
+#endif
+
+	data = nullptr;
+	grid = nullptr;
+	solution = nullptr;
+	fileSize = 0;
+}
+
+bool MappedMaze::VerifyChecksum() const
+{
+	if (!IsOpen())
+		return false;
+
+	std::size_t words = (fileSize - MazeFile::headerSize) / sizeof(std::uint64_t);
+	return Checksum(grid, words, checksumSeed) == checksum;
+}
+
+bool MappedMaze::IsInside(GridPosition position) const
+{
+	return position.x >= 0 && position.x < width && position.y >= 0 && position.y < height;
+}
+
+bool MappedMaze::HasTileAt(int gridX, int gridY, TileType type) const
+{
+	if (!IsInside({ gridX, gridY }))
+		return false;
+
+	bool exit = gridX == exitPosition.x && gridY == exitPosition.y;
+
+	switch (type)
+	{
+		case TileType::Wall:
+			return IsWall(gridX, gridY);
+		case TileType::Exit:
+			return exit;
+		default:
+			return !exit && !IsWall(gridX, gridY);
+	}
+}
+
+std::unique_ptr<Maze> MappedMaze::ToMaze() const
+{
+	Matrix<TileType> tiles(width, height, TileType::Path);
+
+	for (int x = 0; x < width; x++)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			if (IsWall(x, y)) {
+				tiles[x][y] = TileType::Wall;
+			}
+		}
+	}
+
+	tiles[exitPosition.x][exitPosition.y] = TileType::Exit;
+
+	auto maze = std::make_unique<Maze>(std::move(tiles), startPosition, exitPosition, seed);
+	maze->SetSolution(std::vector<std::uint32_t>(solution, solution + solutionLength));
+	return maze;
+}
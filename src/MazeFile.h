@@ -0,0 +1,116 @@
+#ifndef MAZE_FILE_H
+#define MAZE_FILE_H
+
+#include "Maze.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// A binary file format for mazes, version 1. All numbers are little-endian.
+//
+//   offset  size  contents
+//        0     4  magic "MAZE"
+//        4     2  version
+//        6     2  flags (bit 0: a solution follows the grid)
+//        8     4  width
+//       12     4  height
+//       16     8  seed
+//       24    16  start x, start y, exit x, exit y (4 bytes each)
+//       40     4  number of cells in the solution
+//       44     4  words per row of the grid
+//       48     8  checksum of everything after the header
+//       56     8  reserved, zero
+//       64        grid: one bit per cell, set for walls, row by row with
+//                 every row padded to whole 64-bit words. The exit is a
+//                 cleared bit; its position is in the header.
+//                 solution: the cell indices (y * width + x) from start to exit.
+namespace MazeFile
+{
+	const std::uint32_t version = 1;
+	const std::size_t headerSize = 64;
+
+	// Writes the maze to a file, with its current solution if asked to.
+	// Returns false if the file could not be written.
+	bool Write(const Maze& maze, const char* path, bool includeSolution = true);
+
+	// The size of the file Write makes for the maze.
+	std::size_t GetFileSize(const Maze& maze, bool includeSolution = true);
+
+	// The text dump: a header line followed by the rows, where '#' is a
+	// wall, 'E' is the exit and '.' is on the solution path. lines is
+	// scratch space that can be kept between calls.
+	bool WriteText(const Maze& maze, std::FILE* file, std::vector<char>& lines);
+	// Reads a maze back from a text dump. The solution cells are marked
+	// but not ordered, so the maze has no solution. Returns null if the
+	// text is not a maze.
+	std::unique_ptr<Maze> ReadText(std::FILE* file);
+}
+
+// A maze file mapped into memory. Queries read the mapped pages
+// directly: opening a file reads only its header, and nothing is 
+// copied unless the maze is converted back to a Maze.
+class MappedMaze
+{
+	public:
+		MappedMaze() { }
+		~MappedMaze();
+
+		MappedMaze(const MappedMaze&) = delete;
+		MappedMaze& operator=(const MappedMaze&) = delete;
+
+		// Maps the file and checks its header and size, and that the
+		// start, the exit and every cell of the solution are inside the
+		// grid. The checksum is not checked, since that means reading
+		// the whole file.
+		bool Open(const char* path);
+		void Close();
+		bool IsOpen() const { return data != nullptr; }
+
+		// Reads the whole file and compares it against the stored checksum.
+		bool VerifyChecksum() const;
+
+		bool HasTileAt(int gridX, int gridY, TileType type) const;
+		bool IsWall(int gridX, int gridY) const
+		{
+			const std::uint64_t* row = grid + static_cast<std::size_t>(gridY) * wordsPerRow;
+			return (row[gridX >> 6] >> (gridX & 63)) & 1;
+		}
+
+		int GetWidth() const { return width; }
+		int GetHeight() const { return height; }
+		GridPosition GetStartPosition() const { return startPosition; }
+		GridPosition GetExitPosition() const { return exitPosition; }
+		std::uint64_t GetSeed() const { return seed; }
+
+		bool HasSolution() const { return solution != nullptr; }
+		const std::uint32_t* GetSolution() const { return solution; }
+		std::size_t GetSolutionLength() const { return solutionLength; }
+
+		// Copies the maze out of the file.
+		std::unique_ptr<Maze> ToMaze() const;
+
+	private:
+		const unsigned char* data {nullptr};
+		std::size_t fileSize {0};
+		const std::uint64_t* grid {nullptr};
+		const std::uint32_t* solution {nullptr};
+		std::size_t solutionLength {0};
+		std::size_t wordsPerRow {0};
+		std::uint64_t checksum {0};
+		int width {0};
+		int height {0};
+		GridPosition startPosition;
+		GridPosition exitPosition;
+		std::uint64_t seed {0};
+
+		bool IsInside(GridPosition position) const;
+
+#ifdef _WIN32
+		void* fileHandle {nullptr};
+		void* mappingHandle {nullptr};
+#endif
+};
+
+#endif
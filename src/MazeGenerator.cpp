@@ -1,260 +1,290 @@
 #include "MazeGenerator.h"
-#include <chrono>
+#include "Profiler.h"
 #include <vector>
+#include <utility>
 #include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <thread>
 #include <assert.h>
 
+// The size of a region for parallel carving, in lattice cells.
+// Regions do not depend on the number of threads, which keeps the
+// result the same for any thread count.
+static const int regionSize = 64;
+
+MazeGenerator::MazeGenerator(std::uint64_t seed) : seedSequence(seed)
+{
+}
+
 // Generates a maze randomly. Width and Height must be odd numbers
-// in order to create a proper maze. Uses depth-first search. 
-// For more information: http://www.migapro.com/depth-first-search/.
+// in order to create a proper maze. Uses depth-first search unless
+// another carver was set. For more information:
+// http://www.migapro.com/depth-first-search/.
+// The seed of the maze is taken from the seed sequence of the generator.
+std::unique_ptr<Maze> 
+MazeGenerator::Create(const int width, const int height)
+{
+	return Create(width, height, seedSequence());
+}
+
+// Generates a maze from the given seed. The same seed and size
+// always produce the same maze, regardless of platform.
+std::unique_ptr<Maze> 
+MazeGenerator::Create(const int width, const int height, std::uint64_t seed)
+{
+	GridPosition startPosition;
+	GridPosition exitPosition;
+	Generate(width, height, seed, startPosition, exitPosition);
+
+	MAZE_PROFILE_SCOPE("CreateMaze");
+	return std::make_unique<Maze>(std::move(tiles), startPosition, exitPosition, seed);
+}
+
+void MazeGenerator::Create(const int width, const int height, Maze& maze)
+{
+	Create(width, height, seedSequence(), maze);
+}
+
+// The grid of the maze is borrowed for carving and moved back, so the
+// maze keeps a single buffer from one level to the next.
+void MazeGenerator::Create(const int width, const int height, std::uint64_t seed, Maze& maze)
+{
+	GridPosition startPosition;
+	GridPosition exitPosition;
+
+	tiles = maze.ReleaseTiles();
+	Generate(width, height, seed, startPosition, exitPosition);
+	maze.Reset(std::move(tiles), startPosition, exitPosition, seed);
+}
+
+void MazeGenerator::Generate(int width, int height, std::uint64_t seed,
+			     GridPosition& startPosition, GridPosition& exitPosition)
+{
+	assert(width % 2 == 1 && height % 2 == 1);
+	assert(static_cast<std::uint64_t>(width) * height <= UINT32_MAX);
+
+	MAZE_PROFILE_SCOPE("Generate");
+
+	random.Seed(seed);
+	InitializeTiles(width, height);
+
+	startPosition = RandomStartPosition();
+
+	MazeCarver& selectedCarver = customCarver ? *customCarver : static_cast<MazeCarver&>(carver);
+	selectedCarver.Carve(tiles, random, startPosition, GetBounds());
+	exitPosition = CreateRandomExit(startPosition);
+}
+
+// Generates a maze by splitting the lattice into square regions,
+// carving each region with its own depth-first search on a pool of
+// threads and finally knocking one wall between neighbouring regions
+// along a random spanning tree of the regions. A spanning tree of
+// spanning trees is still a spanning tree, so the maze stays perfect.
 std::unique_ptr<Maze> 
-MazeGenerator::Create(const int width, const int height, 
-                      int resolutionWidth, int resolutionHeight)
+MazeGenerator::CreateParallel(const int width, const int height, 
+			      std::uint64_t seed, int threadCount)
 {
-	assert(width % 3 == 0 && height % 3 == 0);
-	assert(width == height);
+	assert(width % 2 == 1 && height % 2 == 1);
+	assert(static_cast<std::uint64_t>(width) * height <= UINT32_MAX);
 
-	InitializeTiles(width, height, resolutionWidth, resolutionHeight);
+	MAZE_PROFILE_SCOPE("GenerateParallel");
 
-	sf::Vector2i startPosition = RandomStartPosition();
-	tiles[startPosition.x][startPosition.y].SetType(TileType::Path);
+	random.Seed(seed);
+	InitializeTiles(width, height);
 
-	Carve(startPosition);
-	CreateRandomExit(startPosition);
-	auto wallVertices = CreateWalls();
+	GridPosition startPosition = RandomStartPosition();
 
-	tiles[startPosition.x][startPosition.y].SetColor(sf::Color::Black);
+	CarveRegions(seed, threadCount);
+	ConnectRegions();
+	GridPosition exitPosition = CreateRandomExit(startPosition);
 
-	return std::make_unique<Maze>(tiles, wallVertices, startPosition);
+	return std::make_unique<Maze>(std::move(tiles), startPosition, exitPosition, seed);
+}
+
+void MazeGenerator::SetCarver(std::unique_ptr<MazeCarver> carver)
+{
+	customCarver = std::move(carver);
 }
 
 // By default, the maze is filled with wall tiles,
 // so that the path can be carved through it.
-void MazeGenerator::InitializeTiles(int width, int height,
-				    int resolutionWidth, int resolutionHeight)
+void MazeGenerator::InitializeTiles(int width, int height)
 {
-	tiles = Matrix<Tile>(width, height);
+	MAZE_PROFILE_SCOPE("InitializeTiles");
+	tiles.Reset(width, height, TileType::Wall);
 	this->width = width;
 	this->height = height;
-	sf::RectangleShape rectangle;
+}
+
+// The whole lattice of odd cells inside the border.
+CarveBounds MazeGenerator::GetBounds() const
+{
+	return { 1, 1, width - 2, height - 2 };
+}
+
+CarveBounds MazeGenerator::GetRegionBounds(int regionX, int regionY) const
+{
+	CarveBounds bounds;
+	bounds.minX = 1 + 2 * regionX * regionSize;
+	bounds.minY = 1 + 2 * regionY * regionSize;
+	bounds.maxX = std::min(bounds.minX + 2 * (regionSize - 1), width - 2);
+	bounds.maxY = std::min(bounds.minY + 2 * (regionSize - 1), height - 2);
+	return bounds;
+}
 
-	// Tile size is scaled depending on resolution to fill the window.
-	float sizeX = static_cast<float>(resolutionWidth) / width;
-	float sizeY = static_cast<float>(resolutionHeight) / height;
-	sf::Vector2f size = { sizeX, sizeY };
+// Carves every region on its own. Each region gets a random engine
+// seeded from the maze seed and the region index, so the order in
+// which threads pick up regions does not affect the result.
+void MazeGenerator::CarveRegions(std::uint64_t seed, int threadCount)
+{
+	int columns = (width - 1) / 2;
+	int rows = (height - 1) / 2;
+	int regionsX = (columns + regionSize - 1) / regionSize;
+	int regionsY = (rows + regionSize - 1) / regionSize;
+	int regionCount = regionsX * regionsY;
+
+	if (threadCount <= 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
 
-	rectangle.setSize(size);
-	rectangle.setOutlineThickness(1.0f);
+	threadCount = std::min(threadCount, regionCount);
+	regionCarvers.resize(threadCount);
 
-	for (int x = 0; x < width; x++)
+	std::atomic<int> nextRegion(0);
+
+	auto work = [&](DepthFirstCarver& regionCarver)
 	{
-		for (int y = 0; y < height; y++)
+		for (int region = nextRegion++; region < regionCount; region = nextRegion++)
 		{
-			Tile tile = Tile(TileType::Wall, rectangle);
-			tiles[x][y] = tile;
-			tiles[x][y].SetPosition({ x, y });
+			CarveBounds bounds = GetRegionBounds(region % regionsX, region / regionsX);
+			RandomEngine regionRandom(seed ^ (0x9E3779B97F4A7C15ull * (region + 1)));
+
+			int x = bounds.minX + 2 * RandomBelow(regionRandom, (bounds.maxX - bounds.minX) / 2 + 1);
+			int y = bounds.minY + 2 * RandomBelow(regionRandom, (bounds.maxY - bounds.minY) / 2 + 1);
+
+			regionCarver.Carve(tiles, regionRandom, { x, y }, bounds);
 		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < threadCount; i++) {
+		threads.emplace_back(work, std::ref(regionCarvers[i]));
+	}
+
+	work(regionCarvers[0]);
+
+	for (std::thread& thread : threads) {
+		thread.join();
 	}
 }
 
-// Creates the actual maze by going to four random
-// directions and knocking walls in the path.
-void MazeGenerator::Carve(sf::Vector2i currentPosition)
+// Joins the carved regions into a single maze. The walls between
+// regions are shuffled and a wall is knocked whenever it joins two
+// regions that are not yet connected (Kruskal's algorithm), which
+// opens exactly one wall along each edge of a spanning tree.
+void MazeGenerator::ConnectRegions()
 {
-	Direction directions[] =
-	{ 
-	   Direction::Up,
-	   Direction::Down,
-	   Direction::Left,
-	   Direction::Right 
-	};
+	MAZE_PROFILE_SCOPE("ConnectRegions");
+
+	int columns = (width - 1) / 2;
+	int rows = (height - 1) / 2;
+	int regionsX = (columns + regionSize - 1) / regionSize;
+	int regionsY = (rows + regionSize - 1) / regionSize;
 
-	std::random_shuffle(std::begin(directions), std::end(directions));
+	// Each edge is stored as the index of a region and whether the
+	// neighbour is to the right (0) or below (1).
+	std::vector<std::uint32_t> edges;
 
-	for (int i = 0; i < 4; i++)
+	for (int region = 0; region < regionsX * regionsY; region++)
 	{
-		if (!KnockWall(directions[i], currentPosition)) {
-			continue;
+		if (region % regionsX < regionsX - 1) {
+			edges.push_back(region * 2);
+		}
+
+		if (region / regionsX < regionsY - 1) {
+			edges.push_back(region * 2 + 1);
 		}
 	}
-}
 
-// Tries to knock down a wall from a position to a given direction.
-// Returns false if index is out of bounds. Continues carving
-// recursively until the whole maze has been formed.
-bool MazeGenerator::KnockWall(Direction direction, sf::Vector2i currentPosition)
-{
-	int& x = currentPosition.x;
-	int& y = currentPosition.y;
+	RandomShuffle(random, edges.begin(), edges.end());
 
-	switch (direction)
+	std::vector<int> parents(regionsX * regionsY);
+	std::iota(parents.begin(), parents.end(), 0);
+
+	auto find = [&](int region)
 	{
-		case Direction::Up:
-			if (y <= 2)
-				return false;
-			if (tiles[x][y - 2].GetType() != TileType::Path)
-			{
-				tiles[x][y - 1].SetType(TileType::Path);
-				tiles[x][y - 2].SetType(TileType::Path);
-				Carve({ currentPosition.x, currentPosition.y - 2 });
-				return true;
-			}
-			break;
-		case Direction::Down:
-			if (y + 2 >= tiles.GetHeight() - 1)
-				return false;
-			if (tiles[x][y + 2].GetType() != TileType::Path)
-			{
-				tiles[x][y + 1].SetType(TileType::Path);
-				tiles[x][y + 2].SetType(TileType::Path);
-				Carve({ currentPosition.x, currentPosition.y + 2 });
-				return true;
-			}
-			break;
-		case Direction::Left:
-			if (x <= 2)
-				return false;
-			if (tiles[x - 2][y].GetType() != TileType::Path)
-			{
-				tiles[x - 1][y].SetType(TileType::Path);
-				tiles[x - 2][y].SetType(TileType::Path);
-				Carve({ currentPosition.x - 2, currentPosition.y });
-				return true;
-			}
-			break;
-		case Direction::Right:
-			if (x + 2 >= tiles.GetWidth() - 1)
-				return false;
-			if (tiles[x + 2][y].GetType() != TileType::Path)
-			{
-				tiles[x + 1][y].SetType(TileType::Path);
-				tiles[x + 2][y].SetType(TileType::Path);
-				Carve({ currentPosition.x + 2, currentPosition.y });
-				return true;
-			}
-			break;
-	}
+		while (parents[region] != region)
+		{
+			parents[region] = parents[parents[region]];
+			region = parents[region];
+		}
 
-	return false;
-}
+		return region;
+	};
 
-// Creates walls of the Maze by traversing the Matrix and adding
-// vertices between centers of adjacent walls.
-std::vector<sf::Vertex> 
-MazeGenerator::CreateWalls()
-{
-	std::vector<sf::Vertex> vertices;
+	for (std::uint32_t edge : edges)
+	{
+		int region = edge / 2;
+		bool below = (edge % 2) == 1;
+		int neighbour = below ? region + regionsX : region + 1;
 
-	sf::Color wallColor = sf::Color::Green;
+		int root = find(region);
+		int neighbourRoot = find(neighbour);
 
-	// A line is determined between current wall and adjacent wall for the whole grid.
-	for (int x = 0; x < width; x++)
-	{
-		for (int y = 0; y < height; y++)
+		if (root == neighbourRoot)
+			continue;
+
+		parents[root] = neighbourRoot;
+
+		// Knock a random wall on the border between the two regions.
+		CarveBounds bounds = GetRegionBounds(region % regionsX, region / regionsX);
+
+		if (below)
+		{
+			int x = bounds.minX + 2 * RandomBelow(random, (bounds.maxX - bounds.minX) / 2 + 1);
+			tiles[x][bounds.maxY + 1] = TileType::Path;
+		}
+		else
 		{
-			tiles[x][y].SetColor(sf::Color::White);
-
-			if (tiles[x][y].GetType() == TileType::Path || tiles[x][y].GetType() == TileType::Exit)
-				continue;
-
-			// Each direction is checked for any adjacent wall tiles, which determines
-			// if vertices must be added to the container.
-
-			bool wallRight = (x < width - 1 && tiles[x + 1][y].GetType() == TileType::Wall);
-			bool wallLeft  = (x > 0 && tiles[x - 1][y].GetType() == TileType::Wall);
-			bool wallDown  = (y < height - 1 && tiles[x][y + 1].GetType() == TileType::Wall);
-			bool wallUp    = (y > 0 && tiles[x][y - 1].GetType() == TileType::Wall);
-
-			if (wallRight)
-			{
-				vertices.push_back({ tiles[x][y].GetCenter(), wallColor });
-				vertices.push_back({ tiles[x + 1][y].GetCenter(), wallColor });
-			}
-
-			if (wallLeft)
-			{
-				vertices.push_back({ tiles[x][y].GetCenter(), wallColor });
-				vertices.push_back({ tiles[x - 1][y].GetCenter(), wallColor });
-			}
-
-			if (wallDown)
-			{
-				vertices.push_back({ tiles[x][y].GetCenter(), wallColor });
-				vertices.push_back({ tiles[x][y + 1].GetCenter(), wallColor });
-			}
-
-			if (wallUp)
-			{
-				vertices.push_back({ tiles[x][y].GetCenter(), wallColor });
-				vertices.push_back({ tiles[x][y - 1].GetCenter(), wallColor });
-			}
+			int y = bounds.minY + 2 * RandomBelow(random, (bounds.maxY - bounds.minY) / 2 + 1);
+			tiles[bounds.maxX + 1][y] = TileType::Path;
 		}
 	}
-
-	return vertices;
 }
 
 // Returns a random starting position, which must be odd
 // to generate a proper maze.
-sf::Vector2i MazeGenerator::RandomStartPosition()
+GridPosition MazeGenerator::RandomStartPosition()
 {
-	using namespace std::chrono;
-	auto time = system_clock::now().time_since_epoch();
-	milliseconds ms = duration_cast<milliseconds>(time);
-	srand(ms.count());
-
-	int x = rand() % width;
-	int y = rand() % height;
-
-	while (x % 2 == 0) {
-		x = rand() % width;
-	}
-
-	while (y % 2 == 0) {
-		y = rand() % height;
-	}
+	int x = 1 + 2 * RandomBelow(random, (width - 1) / 2);
+	int y = 1 + 2 * RandomBelow(random, (height - 1) / 2);
 
 	return { x, y };
 }
 
 // Creates an exit for the maze on one of the border tiles (excluding corners).
+// The exit is placed at an odd position along the border, next to a
+// carved cell, so that opening it never creates a loop in the maze.
 // startPosition: The position the player starts from.
-void MazeGenerator::CreateRandomExit(sf::Vector2i startPosition)
+GridPosition MazeGenerator::CreateRandomExit(GridPosition startPosition)
 {
-	std::vector<sf::Vector2i> exitPositions;
+	MAZE_PROFILE_SCOPE("CreateRandomExit");
 
-	// Top and bottom border positions
-	for (int x = 1; x < width - 1; x++)
-	{
-		exitPositions.push_back({ x, 0 });
-		exitPositions.push_back({ x, height - 1 });
-	}
+	int index = static_cast<int>(RandomBelow(random, GetExitCount(width, height)));
+	GridPosition exit = GetExitPosition(index, width, height);
+	GridPosition inside = GetExitNeighbour(exit, width, height);
 
-	// Left and right border positions
-	for (int y = 1; y < height - 1; y++)
-	{
-		exitPositions.push_back({ 0, y });
-		exitPositions.push_back({ width - 1, y });
-	}
+	tiles[exit.x][exit.y] = TileType::Exit;
 
-	std::random_shuffle(std::begin(exitPositions), std::end(exitPositions));
+	// Make sure the tile next to the exit is open.
+	tiles[inside.x][inside.y] = TileType::Path;
 
-	int x = exitPositions[0].x;
-	int y = exitPositions[0].y;
-
-	tiles[x][y].SetType(TileType::Exit);
+	return exit;
+}
 
-	// There can be a wall tile next to the exit, therefore it must be cleared.
-	if (x == 0) {
-		tiles[x + 1][y].SetType(TileType::Path);
-	}
-	else if (x == width - 1) {
-		tiles[x - 1][y].SetType(TileType::Path);
-	}
-	else if (y == 0) {
-		tiles[x][y + 1].SetType(TileType::Path);
-	}
-	else if (y == height - 1) {
-		tiles[x][y - 1].SetType(TileType::Path);
-	}
+std::size_t MazeGenerator::GetMaxCarveStackBytes(int width, int height)
+{
+	return DepthFirstCarver::GetMaxStackBytes({ 1, 1, width - 2, height - 2 });
 }
@@ -2,32 +2,62 @@
 #define MAZE_GENERATOR_H
 
 #include <memory>
+#include <cstdint>
+#include <vector>
 #include "Maze.h"
-
-enum class Direction { Up, Down, Left, Right };
+#include "DepthFirstCarver.h"
+#include "Random.h"
 
 class MazeGenerator
 {
 	public:
-		std::unique_ptr<Maze> Create(int width, int height, 
-			                         int resolutionWidth, int resolutionHeight);
+		explicit MazeGenerator(std::uint64_t seed = 0);
+
+		std::unique_ptr<Maze> Create(int width, int height);
+		std::unique_ptr<Maze> Create(int width, int height, std::uint64_t seed);
+
+		// Generate into an existing maze instead, reusing its grid. Once
+		// the generator and the maze have held a maze at least this big,
+		// nothing is allocated.
+		void Create(int width, int height, Maze& maze);
+		void Create(int width, int height, std::uint64_t seed, Maze& maze);
+
+		// Carves the maze in independent regions on several threads.
+		// The result is a perfect maze that only depends on the seed,
+		// never on the number of threads (0 uses every hardware thread).
+		std::unique_ptr<Maze> CreateParallel(int width, int height, 
+		                                     std::uint64_t seed, int threadCount = 0);
+
+		// Carves with another algorithm from now on, e.g. a ColumnCarver
+		// for throughput; nullptr goes back to the depth-first search.
+		// Only Create uses it: CreateParallel always carves its regions
+		// depth first.
+		void SetCarver(std::unique_ptr<MazeCarver> carver);
+
+		static std::size_t GetMaxCarveStackBytes(int width, int height);
 
 	private:
-		Matrix<Tile> tiles;
+		Matrix<TileType> tiles;
+		DepthFirstCarver carver;
+		std::unique_ptr<MazeCarver> customCarver;
+		std::vector<DepthFirstCarver> regionCarvers;
+		RandomEngine seedSequence;
+		RandomEngine random;
 		int width {0};
 		int height {0};
 
-		void InitializeTiles(int width, int height,
-			                 int resolutionWidth, int resolutionHeight);
-
-		std::vector<sf::Vertex> CreateWalls();
-		void Carve(sf::Vector2i currentPosition);
-		void CreateRandomExit(sf::Vector2i startPosition);
+		// Carves a maze into tiles with the selected carver.
+		void Generate(int width, int height, std::uint64_t seed,
+		              GridPosition& startPosition, GridPosition& exitPosition);
+		void InitializeTiles(int width, int height);
 
-		bool KnockWall(Direction direction, sf::Vector2i currentPosition);
+		CarveBounds GetBounds() const;
+		CarveBounds GetRegionBounds(int regionX, int regionY) const;
+		void CarveRegions(std::uint64_t seed, int threadCount);
+		void ConnectRegions();
+		GridPosition CreateRandomExit(GridPosition startPosition);
 
-		Direction GetRandomDirection();
-		sf::Vector2i RandomStartPosition();	
+		GridPosition RandomStartPosition();	
 };
 
 #endif
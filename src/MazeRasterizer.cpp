@@ -0,0 +1,140 @@
+#include "MazeRasterizer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cstring>
+
+bool MazeRasterizer::Write(const Maze& maze, const RasterSettings& settings, ImageEncoder& encoder, std::FILE* file)
+{
+	MAZE_PROFILE_SCOPE("RasterizeMaze");
+
+	int width = maze.GetWidth();
+	int height = maze.GetHeight();
+	int pixelsPerCell = std::max(1, settings.pixelsPerCell);
+	const Matrix<TileType>& tiles = maze.GetTiles();
+
+	BuildSpans(settings);
+	cellColors.resize(width);
+	pixels.resize(static_cast<std::size_t>(width) * pixelsPerCell * 3);
+
+	// Cell indices grow row by row, so the sorted solution can be
+	// walked along with the rows.
+	solution.clear();
+
+	if (settings.drawSolution)
+	{
+		solution = maze.GetSolution();
+		std::sort(solution.begin(), solution.end());
+	}
+
+	auto nextSolution = solution.begin();
+	GridPosition start = maze.GetStartPosition();
+
+	if (!encoder.Begin(file, width * pixelsPerCell, height * pixelsPerCell))
+		return false;
+
+	for (int y = 0; y < height; y++)
+	{
+		// The first colors follow the order of the tile types.
+		for (int x = 0; x < width; x++) {
+			cellColors[x] = static_cast<CellColor>(tiles(x, y));
+		}
+
+		std::uint32_t rowEnd = static_cast<std::uint32_t>(y + 1) * width;
+
+		for (; nextSolution != solution.end() && *nextSolution < rowEnd; ++nextSolution)
+		{
+			int x = static_cast<int>(*nextSolution - (rowEnd - width));
+
+			if (cellColors[x] == CellColor::Path) {
+				cellColors[x] = CellColor::Solution;
+			}
+		}
+
+		if (settings.drawMarks && y == start.y) {
+			cellColors[start.x] = CellColor::Start;
+		}
+
+		FillRow(pixelsPerCell);
+
+		for (int row = 0; row < pixelsPerCell; row++)
+		{
+			if (!encoder.WriteRow(pixels.data()))
+				return false;
+		}
+	}
+
+	return encoder.End();
+}
+
+bool MazeRasterizer::Write(const Maze& maze, const RasterSettings& settings, const char* path)
+{
+	std::size_t length = std::strlen(path);
+	bool ppm = length >= 4 && std::strcmp(path + length - 4, ".ppm") == 0;
+
+	std::FILE* file = std::fopen(path, "wb");
+
+	if (file == nullptr)
+		return false;
+
+	PpmEncoder ppmEncoder;
+	PngEncoder pngEncoder;
+	bool written = Write(maze, settings, ppm ? static_cast<ImageEncoder&>(ppmEncoder) : pngEncoder, file);
+
+	return std::fclose(file) == 0 && written;
+}
+
+// Without marks, the start is not drawn at all and the exit is drawn
+// like the path.
+void MazeRasterizer::BuildSpans(const RasterSettings& settings)
+{
+	ImageColor palette[static_cast<int>(CellColor::Count)];
+	palette[static_cast<int>(CellColor::Path)] = settings.pathColor;
+	palette[static_cast<int>(CellColor::Wall)] = settings.wallColor;
+	palette[static_cast<int>(CellColor::Exit)] = settings.drawMarks ? settings.exitColor : settings.pathColor;
+	palette[static_cast<int>(CellColor::Solution)] = settings.solutionColor;
+	palette[static_cast<int>(CellColor::Start)] = settings.startColor;
+
+	spans.resize(static_cast<std::size_t>(CellColor::Count) * spanPixels * 3);
+
+	for (int color = 0; color < static_cast<int>(CellColor::Count); color++)
+	{
+		std::uint8_t* span = &spans[color * spanPixels * 3];
+
+		for (std::size_t pixel = 0; pixel < spanPixels; pixel++)
+		{
+			span[pixel * 3] = palette[color].r;
+			span[pixel * 3 + 1] = palette[color].g;
+			span[pixel * 3 + 2] = palette[color].b;
+		}
+	}
+}
+
+// Every run of cells with the same color is copied from the span of
+// that color, whole spans at a time.
+void MazeRasterizer::FillRow(int pixelsPerCell)
+{
+	int width = static_cast<int>(cellColors.size());
+	std::uint8_t* out = pixels.data();
+	int x = 0;
+
+	while (x < width)
+	{
+		CellColor color = cellColors[x];
+		int end = x + 1;
+
+		while (end < width && cellColors[end] == color) {
+			end++;
+		}
+
+		const std::uint8_t* span = &spans[static_cast<std::size_t>(color) * spanPixels * 3];
+		std::size_t count = static_cast<std::size_t>(end - x) * pixelsPerCell;
+
+		for (; count > spanPixels; count -= spanPixels, out += spanPixels * 3) {
+			std::memcpy(out, span, spanPixels * 3);
+		}
+
+		std::memcpy(out, span, count * 3);
+		out += count * 3;
+		x = end;
+	}
+}
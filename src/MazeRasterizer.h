@@ -0,0 +1,61 @@
+#ifndef MAZE_RASTERIZER_H
+#define MAZE_RASTERIZER_H
+
+#include "Maze.h"
+#include "ImageEncoder.h"
+#include <cstdint>
+#include <vector>
+
+struct ImageColor
+{
+	std::uint8_t r {0};
+	std::uint8_t g {0};
+	std::uint8_t b {0};
+};
+
+struct RasterSettings
+{
+	// Every cell becomes a square of this many pixels on each side.
+	int pixelsPerCell {4};
+	bool drawSolution {true};
+	// Marks the start and the exit in their own colors.
+	bool drawMarks {true};
+
+	ImageColor pathColor {255, 255, 255};
+	ImageColor wallColor {0, 255, 0};
+	ImageColor solutionColor {255, 0, 0};
+	ImageColor startColor {0, 0, 0};
+	ImageColor exitColor {0, 0, 255};
+};
+
+// Draws mazes into images without a window, straight from the grid.
+// A row of cells is first reduced to a row of colors, then every run
+// of cells with the same color is filled as one span of pixels. The
+// pixel row is handed to the encoder once for every pixel row of the
+// cells, so only a single row of the image is ever in memory.
+class MazeRasterizer
+{
+	public:
+		// Returns false if the encoder could not write the image.
+		bool Write(const Maze& maze, const RasterSettings& settings, ImageEncoder& encoder, std::FILE* file);
+
+		// Writes the image to a file, as PNG unless the path ends in ".ppm".
+		bool Write(const Maze& maze, const RasterSettings& settings, const char* path);
+
+	private:
+		enum class CellColor : std::uint8_t { Path, Wall, Exit, Solution, Start, Count };
+
+		// Pixels copied per span fill.
+		static constexpr std::size_t spanPixels = 64;
+
+		std::vector<CellColor> cellColors;
+		std::vector<std::uint8_t> pixels;
+		// One span of pixels for each cell color.
+		std::vector<std::uint8_t> spans;
+		std::vector<std::uint32_t> solution;
+
+		void BuildSpans(const RasterSettings& settings);
+		void FillRow(int pixelsPerCell);
+};
+
+#endif
@@ -0,0 +1,284 @@
+#include "MazeSolver.h"
+#include "Maze.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <cstdlib>
+
+// Directions in the order the walker tries them: up, right, down, left.
+// Opposite directions are two steps apart.
+static const int offsetX[] = { 0, 1, 0, -1 };
+static const int offsetY[] = { -1, 0, 1, 0 };
+
+static int Opposite(int direction)
+{
+	return (direction + 2) & 3;
+}
+
+const std::vector<std::uint32_t>& MazeSolver::Solve(const Maze& maze)
+{
+	using namespace std::chrono;
+	auto begin = steady_clock::now();
+
+	Prepare(maze);
+
+	bool found = false;
+
+	switch (algorithm)
+	{
+		case SolverAlgorithm::Walker:
+			found = SolveWalker(maze);
+			break;
+		case SolverAlgorithm::BreadthFirst:
+			found = SolveBreadthFirst(maze);
+			break;
+		case SolverAlgorithm::AStar:
+			found = SolveAStar(maze);
+			break;
+		case SolverAlgorithm::DeadEndFilling:
+			found = SolveDeadEndFilling(maze);
+			break;
+	}
+
+	if (!found) {
+		path.clear();
+	}
+
+	stats.nanoseconds = duration_cast<nanoseconds>(steady_clock::now() - begin).count();
+	MAZE_PROFILE_COUNT("NodesExpanded", stats.nodesExpanded);
+
+	return path;
+}
+
+// Sizes the scratch buffers for the maze. Capacity is kept from
+// previous solves, so this only allocates when the maze is bigger
+// than any maze solved before.
+void MazeSolver::Prepare(const Maze& maze)
+{
+	width = maze.GetWidth();
+	height = maze.GetHeight();
+
+	std::size_t cellCount = static_cast<std::size_t>(width) * height;
+	std::size_t wordCount = (cellCount + 63) / 64;
+
+	visited.assign(wordCount, 0);
+	parents.resize(cellCount);
+	path.clear();
+	frontier.clear();
+
+	// Neither the frontier nor a path holds an open tile twice, so with
+	// room for every open tile, later solves of this size never allocate.
+	// The reservation is not free: Windows commits all of it up front.
+	frontier.reserve(GetOpenTileCount(width, height));
+	path.reserve(GetOpenTileCount(width, height));
+
+	if (algorithm == SolverAlgorithm::AStar)
+	{
+		closed.assign(wordCount, 0);
+		costs.resize(cellCount);
+		openSet.clear();
+	}
+
+	stats = SolverStats();
+	stats.cellCount = cellCount;
+}
+
+// Returns true if the neighbour of a cell in the given direction
+// is inside the maze and not a wall.
+bool MazeSolver::IsOpen(const Maze& maze, std::uint32_t index, int direction, 
+			std::uint32_t& outIndex) const
+{
+	int x = static_cast<int>(index % width) + offsetX[direction];
+	int y = static_cast<int>(index / width) + offsetY[direction];
+
+	if (x < 0 || x >= width || y < 0 || y >= height)
+		return false;
+
+	if (maze.GetTiles()(x, y) == TileType::Wall)
+		return false;
+
+	if (algorithm == SolverAlgorithm::DeadEndFilling && !deadEndFiller.IsOpen(x, y))
+		return false;
+
+	outIndex = static_cast<std::uint32_t>(y) * width + x;
+	return true;
+}
+
+// The original solver: a walker that traverses the maze sequentially
+// along the path until it reaches the exit or a dead end. In the case 
+// of a dead end it backtracks to a position where it can continue. 
+// The cells that remain on the stack form the path from start to exit,
+// which may contain unnecessary detours.
+bool MazeSolver::SolveWalker(const Maze& maze)
+{
+	std::uint32_t start = maze.GetIndex(maze.GetStartPosition());
+	std::uint32_t exit = maze.GetIndex(maze.GetExitPosition());
+
+	path.push_back(start);
+	Set(visited, start);
+
+	while (!path.empty())
+	{
+		std::uint32_t current = path.back();
+		std::uint32_t next;
+		bool moved = false;
+
+		stats.nodesExpanded++;
+
+		// To make sure that the walker does not make stupid moves
+		// by running right by the exit, adjacent tiles are checked
+		// for the exit first.
+		for (int direction = 0; direction < 4; direction++)
+		{
+			if (IsOpen(maze, current, direction, next) && next == exit)
+			{
+				path.push_back(exit);
+				return true;
+			}
+		}
+
+		for (int direction = 0; direction < 4 && !moved; direction++)
+		{
+			if (IsOpen(maze, current, direction, next) && !IsSet(visited, next))
+			{
+				Set(visited, next);
+				path.push_back(next);
+				moved = true;
+			}
+		}
+
+		if (!moved) {
+			// Here we reach a dead end! Backtracking must be applied.
+			path.pop_back();
+		}
+	}
+
+	return false;
+}
+
+// Expands the maze in rings of equal distance from the start,
+// so the exit is reached along a shortest path.
+bool MazeSolver::SolveBreadthFirst(const Maze& maze)
+{
+	std::uint32_t start = maze.GetIndex(maze.GetStartPosition());
+	std::uint32_t exit = maze.GetIndex(maze.GetExitPosition());
+
+	frontier.push_back(start);
+	Set(visited, start);
+
+	for (std::size_t head = 0; head < frontier.size(); head++)
+	{
+		std::uint32_t current = frontier[head];
+		stats.nodesExpanded++;
+
+		if (current == exit)
+		{
+			BuildPath(start, exit);
+			return true;
+		}
+
+		for (int direction = 0; direction < 4; direction++)
+		{
+			std::uint32_t next;
+
+			if (IsOpen(maze, current, direction, next) && !IsSet(visited, next))
+			{
+				Set(visited, next);
+				parents[next] = static_cast<std::uint8_t>(Opposite(direction));
+				frontier.push_back(next);
+			}
+		}
+	}
+
+	return false;
+}
+
+// Expands the cell with the lowest cost plus Manhattan distance to
+// the exit first. The open set is a binary heap of entries that pack
+// the estimate in the upper and the cell index in the lower 32 bits.
+bool MazeSolver::SolveAStar(const Maze& maze)
+{
+	GridPosition exitPosition = maze.GetExitPosition();
+	std::uint32_t start = maze.GetIndex(maze.GetStartPosition());
+	std::uint32_t exit = maze.GetIndex(exitPosition);
+
+	auto estimate = [&](std::uint32_t index, std::uint32_t cost) -> std::uint64_t
+	{
+		int x = static_cast<int>(index % width);
+		int y = static_cast<int>(index / width);
+		std::uint64_t distance = std::abs(x - exitPosition.x) + std::abs(y - exitPosition.y);
+		return ((cost + distance) << 32) | index;
+	};
+
+	costs[start] = 0;
+	Set(visited, start);
+	openSet.push_back(estimate(start, 0));
+
+	while (!openSet.empty())
+	{
+		std::pop_heap(openSet.begin(), openSet.end(), std::greater<std::uint64_t>());
+		auto current = static_cast<std::uint32_t>(openSet.back());
+		openSet.pop_back();
+
+		if (IsSet(closed, current))
+			continue;
+
+		Set(closed, current);
+		stats.nodesExpanded++;
+
+		if (current == exit)
+		{
+			BuildPath(start, exit);
+			return true;
+		}
+
+		for (int direction = 0; direction < 4; direction++)
+		{
+			std::uint32_t next;
+			std::uint32_t cost = costs[current] + 1;
+
+			if (!IsOpen(maze, current, direction, next) || IsSet(closed, next))
+				continue;
+
+			if (!IsSet(visited, next) || cost < costs[next])
+			{
+				Set(visited, next);
+				costs[next] = cost;
+				parents[next] = static_cast<std::uint8_t>(Opposite(direction));
+				openSet.push_back(estimate(next, cost));
+				std::push_heap(openSet.begin(), openSet.end(), std::greater<std::uint64_t>());
+			}
+		}
+	}
+
+	return false;
+}
+
+// Fills every dead end of the maze, after which the breadth-first
+// search only has to walk the cells that are left: the solution.
+bool MazeSolver::SolveDeadEndFilling(const Maze& maze)
+{
+	stats.nodesExpanded = deadEndFiller.Fill(maze);
+
+	return SolveBreadthFirst(maze);
+}
+
+// Follows the parent directions from the exit back to the start.
+void MazeSolver::BuildPath(std::uint32_t start, std::uint32_t exit)
+{
+	path.clear();
+
+	for (std::uint32_t index = exit; ; )
+	{
+		path.push_back(index);
+
+		if (index == start)
+			break;
+
+		int direction = parents[index];
+		index += offsetY[direction] * width + offsetX[direction];
+	}
+
+	std::reverse(path.begin(), path.end());
+}
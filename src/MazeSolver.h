@@ -0,0 +1,91 @@
+#ifndef MAZE_SOLVER_H
+#define MAZE_SOLVER_H
+
+#include "DeadEndFiller.h"
+#include <cstdint>
+#include <vector>
+
+class Maze;
+
+enum class SolverAlgorithm 
+{ 
+	// Follows the first open direction (up, right, down, left) and
+	// backtracks at dead ends. Finds a path, but not the shortest one.
+	Walker,
+	// Breadth-first search, always finds the shortest path.
+	BreadthFirst,
+	// A* with a Manhattan distance heuristic, always finds the
+	// shortest path and usually expands fewer cells than BreadthFirst.
+	AStar,
+	// Fills dead ends with bitboard operations until only the solution
+	// remains, then walks it. Only meant for perfect mazes, where the
+	// result is the same as BreadthFirst.
+	DeadEndFilling
+};
+
+// Statistics of the most recent solve.
+struct SolverStats
+{
+	std::uint64_t nodesExpanded {0};
+	std::uint64_t nanoseconds {0};
+	std::uint64_t cellCount {0};
+
+	double GetNanosecondsPerCell() const
+	{
+		return cellCount > 0 ? static_cast<double>(nanoseconds) / cellCount : 0.0;
+	}
+};
+
+// Finds a path from the start of a maze to its exit. The path is
+// returned as cell indices (y * width + x). All scratch buffers are
+// kept between solves and only grow when a bigger maze is solved,
+// so a single solver can be reused for any number of mazes.
+class MazeSolver
+{
+	public:
+		explicit MazeSolver(SolverAlgorithm algorithm = SolverAlgorithm::BreadthFirst) 
+			: algorithm(algorithm) { }
+
+		const std::vector<std::uint32_t>& Solve(const Maze& maze);
+
+		void SetAlgorithm(SolverAlgorithm algorithm) { this->algorithm = algorithm; }
+		SolverAlgorithm GetAlgorithm() const { return algorithm; }
+		const std::vector<std::uint32_t>& GetPath() const { return path; }
+		const SolverStats& GetStats() const { return stats; }
+
+	private:
+		SolverAlgorithm algorithm;
+		SolverStats stats;
+		int width {0};
+		int height {0};
+
+		std::vector<std::uint32_t> path;
+		std::vector<std::uint32_t> frontier;
+		std::vector<std::uint64_t> openSet;
+		std::vector<std::uint64_t> visited;
+		std::vector<std::uint64_t> closed;
+		std::vector<std::uint32_t> costs;
+		std::vector<std::uint8_t> parents;
+		DeadEndFiller deadEndFiller;
+
+		void Prepare(const Maze& maze);
+		bool SolveWalker(const Maze& maze);
+		bool SolveBreadthFirst(const Maze& maze);
+		bool SolveAStar(const Maze& maze);
+		bool SolveDeadEndFilling(const Maze& maze);
+		void BuildPath(std::uint32_t start, std::uint32_t exit);
+
+		bool IsOpen(const Maze& maze, std::uint32_t index, int direction, std::uint32_t& outIndex) const;
+
+		bool IsSet(const std::vector<std::uint64_t>& bits, std::uint32_t index) const
+		{
+			return (bits[index >> 6] >> (index & 63)) & 1;
+		}
+
+		void Set(std::vector<std::uint64_t>& bits, std::uint32_t index)
+		{
+			bits[index >> 6] |= 1ull << (index & 63);
+		}
+};
+
+#endif
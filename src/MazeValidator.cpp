@@ -0,0 +1,475 @@
+#include "MazeValidator.h"
+#include "WorkStealingPool.h"
+#include "Profiler.h"
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static int CountTrailingZeros(std::uint64_t bits)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(bits);
+#endif
+}
+
+const char* GetRuleName(MazeRule rule)
+{
+	switch (rule)
+	{
+		case MazeRule::Size: return "size";
+		case MazeRule::OpenCells: return "open-cells";
+		case MazeRule::ClosedPillars: return "closed-pillars";
+		case MazeRule::ClosedBorder: return "closed-border";
+		case MazeRule::SingleExit: return "single-exit";
+		case MazeRule::OpenExitNeighbour: return "open-exit-neighbour";
+		case MazeRule::StartOnLattice: return "start-on-lattice";
+		case MazeRule::NoCycles: return "no-cycles";
+		case MazeRule::Connected: return "connected";
+		case MazeRule::ExitReachable: return "exit-reachable";
+		default: return "unknown";
+	}
+}
+
+std::uint64_t ValidationReport::GetViolationCount() const
+{
+	std::uint64_t total = 0;
+
+	for (std::uint64_t count : counts) {
+		total += count;
+	}
+
+	return total;
+}
+
+const ValidationReport& MazeValidator::Validate(const Maze& maze, WorkStealingPool* pool)
+{
+	MAZE_PROFILE_SCOPE("ValidateMaze");
+
+	tiles = &maze.GetTiles();
+	width = maze.GetWidth();
+	height = maze.GetHeight();
+
+	std::fill(std::begin(report.counts), std::end(report.counts), 0);
+	report.violations.clear();
+	report.components = 0;
+	report.bytes = tiles->size();
+
+	if (width < 3 || height < 3 || width % 2 == 0 || height % 2 == 0)
+	{
+		Report(MazeRule::Size, { width, height });
+		return report;
+	}
+
+	columns = (width - 1) / 2;
+	rows = (height - 1) / 2;
+
+	std::size_t cellCount = static_cast<std::size_t>(columns) * rows;
+
+	if (cellCount > parentCapacity)
+	{
+		parents.reset(new std::atomic<std::uint32_t>[cellCount]);
+		parentCapacity = cellCount;
+	}
+
+	stripes.resize((columns + columnsPerStripe - 1) / columnsPerStripe);
+
+	for (std::size_t i = 0; i < stripes.size(); i++)
+	{
+		Stripe& stripe = stripes[i];
+		stripe.firstColumn = static_cast<int>(i) * columnsPerStripe;
+		stripe.endColumn = std::min(stripe.firstColumn + columnsPerStripe, columns);
+		std::fill(std::begin(stripe.counts), std::end(stripe.counts), 0);
+		stripe.violations.clear();
+		stripe.exits.clear();
+		stripe.components = 0;
+	}
+
+	// Components can only be counted once every passage is joined.
+	RunStripes(pool, &MazeValidator::ScanStripe);
+	RunStripes(pool, &MazeValidator::JoinStripe);
+
+	GridPosition start = maze.GetStartPosition();
+	bool startOnLattice = start.x % 2 == 1 && start.y % 2 == 1 && start.x > 0 && start.y > 0 &&
+	                      start.x < width - 1 && start.y < height - 1;
+
+	if (!startOnLattice) {
+		Report(MazeRule::StartOnLattice, start);
+	}
+
+	startRoot = startOnLattice ? Find(static_cast<std::uint32_t>(start.x / 2) * rows + start.y / 2) : 0;
+	RunStripes(pool, &MazeValidator::CountComponents);
+
+	for (const Stripe& stripe : stripes)
+	{
+		for (int rule = 0; rule < static_cast<int>(MazeRule::Count); rule++) {
+			report.counts[rule] += stripe.counts[rule];
+		}
+
+		std::size_t room = maxReported - std::min(maxReported, report.violations.size());
+		report.violations.insert(report.violations.end(), stripe.violations.begin(),
+		                         stripe.violations.begin() + std::min(room, stripe.violations.size()));
+		report.components += stripe.components;
+	}
+
+	CheckExit(maze);
+
+	MAZE_PROFILE_COUNT("ValidatedBytes", report.bytes);
+	return report;
+}
+
+void MazeValidator::RunStripes(WorkStealingPool* pool, void (MazeValidator::*step)(Stripe&))
+{
+	if (pool == nullptr || stripes.size() <= 1)
+	{
+		for (Stripe& stripe : stripes) {
+			(this->*step)(stripe);
+		}
+
+		return;
+	}
+
+	for (Stripe& stripe : stripes) {
+		pool->Submit([this, step, &stripe](int) { (this->*step)(stripe); });
+	}
+
+	pool->Wait();
+}
+
+// Every column of cells is scanned together with the wall column to its
+// left; the last stripe also scans the right border. A column is read
+// 64 rows at a time into masks of the open passages and of the tiles
+// that break a rule, without branches. The cells of a column joined by
+// passages down become runs whose first cell is their parent, which
+// needs no search. Passages left are joined through the union-find,
+// except the ones into the previous stripe, which is still being
+// scanned: JoinStripe joins those.
+void MazeValidator::ScanStripe(Stripe& stripe)
+{
+	const Matrix<TileType>& tiles = *this->tiles;
+
+	for (int column = stripe.firstColumn; column < stripe.endColumn; column++)
+	{
+		int x = 2 * column + 1;
+		const TileType* walls = &tiles(x - 1, 0);
+		const TileType* cells = &tiles(x, 0);
+		std::uint32_t first = static_cast<std::uint32_t>(column) * rows;
+
+		CheckBorderColumn(stripe, x, column == 0);
+
+		std::uint32_t runStart = first;
+		std::uint64_t openAboveFirst = 0;
+
+		for (int firstRow = 0; firstRow < rows; firstRow += 64)
+		{
+			int count = std::min(64, rows - firstRow);
+			std::uint64_t openDown = 0;
+			std::uint64_t openLeft = 0;
+			std::uint64_t closedCells = 0;
+			std::uint64_t exitsBelow = 0;
+			std::uint64_t exitsLeft = 0;
+			std::uint64_t openPillars = 0;
+
+			for (int bit = 0; bit < count; bit++)
+			{
+				const TileType* cell = cells + 2 * (firstRow + bit) + 1;
+				const TileType* wall = walls + 2 * (firstRow + bit) + 1;
+
+				openDown |= std::uint64_t(cell[1] == TileType::Path) << bit;
+				openLeft |= std::uint64_t(wall[0] == TileType::Path) << bit;
+				closedCells |= std::uint64_t(cell[0] != TileType::Path) << bit;
+				exitsBelow |= std::uint64_t(cell[1] == TileType::Exit) << bit;
+				exitsLeft |= std::uint64_t(wall[0] == TileType::Exit) << bit;
+				openPillars |= std::uint64_t(wall[1] != TileType::Wall) << bit;
+			}
+
+			// Below the last row is the border, which is checked on its own,
+			// and so is the wall column of the first column.
+			std::uint64_t below = (firstRow + count == rows) ? ~(std::uint64_t(1) << (count - 1)) : ~std::uint64_t(0);
+			openDown &= below;
+			exitsBelow &= below;
+			openPillars &= below;
+
+			if (column == 0)
+			{
+				openLeft = 0;
+				exitsLeft = 0;
+				openPillars = 0;
+			}
+
+			if ((closedCells | exitsBelow | exitsLeft | openPillars) != 0)
+			{
+				ReportRows(stripe, MazeRule::OpenCells, closedCells, x, firstRow, 0);
+				ReportRows(stripe, MazeRule::SingleExit, exitsBelow, x, firstRow, 1);
+				ReportRows(stripe, MazeRule::SingleExit, exitsLeft, x - 1, firstRow, 0);
+				ReportRows(stripe, MazeRule::ClosedPillars, openPillars, x - 1, firstRow, 1);
+			}
+
+			std::uint64_t openAbove = (openDown << 1) | openAboveFirst;
+			openAboveFirst = openDown >> 63;
+
+			for (int bit = 0; bit < count; bit++)
+			{
+				std::uint32_t cell = first + firstRow + bit;
+				runStart = (openAbove >> bit & 1) ? runStart : cell;
+				parents[cell].store(runStart, std::memory_order_relaxed);
+			}
+
+			if (column == stripe.firstColumn)
+				continue;
+
+			for (; openLeft != 0; openLeft &= openLeft - 1)
+			{
+				int row = firstRow + CountTrailingZeros(openLeft);
+
+				if (!UnionWithinStripe(first - rows + row, first + row)) {
+					Report(stripe, MazeRule::NoCycles, x - 1, 2 * row + 1);
+				}
+			}
+		}
+	}
+
+	if (stripe.endColumn == columns) {
+		CheckBorderColumn(stripe, width, true);
+	}
+}
+
+// Checks the top and bottom of a column of cells and of the wall column
+// to its left, and the whole wall column if it is the border.
+void MazeValidator::CheckBorderColumn(Stripe& stripe, int x, bool wallsOnBorder)
+{
+	const TileType* walls = &(*tiles)(x - 1, 0);
+
+	if (wallsOnBorder)
+	{
+		for (int y = 0; y < height; y++)
+		{
+			if (walls[y] != TileType::Wall) {
+				CheckBorderTile(stripe, x - 1, y);
+			}
+		}
+	}
+	else
+	{
+		for (int y : { 0, height - 1 })
+		{
+			if (walls[y] != TileType::Wall) {
+				CheckBorderTile(stripe, x - 1, y);
+			}
+		}
+	}
+
+	if (x == width)
+		return;
+
+	for (int y : { 0, height - 1 })
+	{
+		if ((*tiles)(x, y) != TileType::Wall) {
+			CheckBorderTile(stripe, x, y);
+		}
+	}
+}
+
+// Joins the passages from the first column of the stripe into the last
+// column of the previous one. Stripes do this at the same time, so the
+// union-find is shared here.
+void MazeValidator::JoinStripe(Stripe& stripe)
+{
+	if (stripe.firstColumn == 0)
+		return;
+
+	int x = 2 * stripe.firstColumn;
+	const TileType* walls = &(*tiles)(x, 0);
+	std::uint32_t first = static_cast<std::uint32_t>(stripe.firstColumn) * rows;
+
+	for (int row = 0; row < rows; row++)
+	{
+		int y = 2 * row + 1;
+
+		if (walls[y] == TileType::Path && !Union(first - rows + row, first + row)) {
+			Report(stripe, MazeRule::NoCycles, x, y);
+		}
+	}
+}
+
+// Every region of cells has a single root: its first cell.
+void MazeValidator::CountComponents(Stripe& stripe)
+{
+	std::uint32_t first = static_cast<std::uint32_t>(stripe.firstColumn) * rows;
+	std::uint32_t end = static_cast<std::uint32_t>(stripe.endColumn) * rows;
+
+	for (std::uint32_t cell = first; cell < end; cell++)
+	{
+		if (parents[cell].load(std::memory_order_relaxed) != cell)
+			continue;
+
+		stripe.components++;
+
+		if (cell != startRoot) {
+			Report(stripe, MazeRule::Connected, 2 * static_cast<int>(cell / rows) + 1, 
+			       2 * static_cast<int>(cell % rows) + 1);
+		}
+	}
+}
+
+void MazeValidator::CheckBorderTile(Stripe& stripe, int x, int y)
+{
+	if ((*tiles)(x, y) == TileType::Exit) {
+		stripe.exits.push_back({ x, y });
+	}
+	else {
+		Report(stripe, MazeRule::ClosedBorder, x, y);
+	}
+}
+
+// The exit must be on an odd tile of the border, which is never a
+// corner, next to an open cell that is connected to the start.
+void MazeValidator::CheckExit(const Maze& maze)
+{
+	const GridPosition* exit = nullptr;
+
+	for (const Stripe& stripe : stripes)
+	{
+		for (const GridPosition& position : stripe.exits)
+		{
+			if (exit != nullptr) {
+				Report(MazeRule::SingleExit, position);
+			}
+			else {
+				exit = &position;
+			}
+		}
+	}
+
+	if (exit == nullptr)
+	{
+		Report(MazeRule::SingleExit, maze.GetExitPosition());
+		return;
+	}
+
+	GridPosition position = *exit;
+	GridPosition inside = GetExitNeighbour(position, width, height);
+	bool onSide = (position.x == 0 || position.x == width - 1);
+	bool onLattice = onSide ? (position.y % 2 == 1) : (position.x % 2 == 1);
+
+	if (!onLattice || position != maze.GetExitPosition())
+	{
+		Report(MazeRule::SingleExit, position);
+		return;
+	}
+
+	if ((*tiles)(inside.x, inside.y) != TileType::Path) {
+		Report(MazeRule::OpenExitNeighbour, inside);
+	}
+	else if (Find(static_cast<std::uint32_t>(inside.x / 2) * rows + inside.y / 2) != startRoot) {
+		Report(MazeRule::ExitReachable, position);
+	}
+}
+
+// Halves the path on the way up. Only roots are ever linked, so an
+// ancestor written here stays an ancestor even if another thread
+// writes a different one at the same time.
+std::uint32_t MazeValidator::Find(std::uint32_t cell)
+{
+	while (true)
+	{
+		std::uint32_t parent = parents[cell].load(std::memory_order_relaxed);
+
+		if (parent == cell)
+			return cell;
+
+		std::uint32_t grandparent = parents[parent].load(std::memory_order_relaxed);
+
+		if (grandparent == parent)
+			return parent;
+
+		parents[cell].store(grandparent, std::memory_order_relaxed);
+		cell = grandparent;
+	}
+}
+
+// Only the thread scanning a stripe touches its cells until the stripes
+// are joined, so there is no need to compare and swap. Nearly every
+// cell is at most two steps below its root, since the cells of a run
+// point at its first cell. Roots are their own parents, so taking two
+// steps without looking is always safe and saves the branches.
+std::uint32_t MazeValidator::FindWithinStripe(std::uint32_t cell)
+{
+	std::uint32_t parent = parents[cell].load(std::memory_order_relaxed);
+	std::uint32_t root = parents[parent].load(std::memory_order_relaxed);
+
+	if (parents[root].load(std::memory_order_relaxed) != root) {
+		root = Find(root);
+	}
+
+	parents[cell].store(root, std::memory_order_relaxed);
+	return root;
+}
+
+bool MazeValidator::UnionWithinStripe(std::uint32_t a, std::uint32_t b)
+{
+	a = FindWithinStripe(a);
+	b = FindWithinStripe(b);
+
+	if (a == b)
+		return false;
+
+	parents[std::max(a, b)].store(std::min(a, b), std::memory_order_relaxed);
+	return true;
+}
+
+// Parents always have smaller indices than their children, so linking
+// never makes a loop, whatever other threads link at the same time.
+bool MazeValidator::Union(std::uint32_t a, std::uint32_t b)
+{
+	while (true)
+	{
+		a = Find(a);
+		b = Find(b);
+
+		if (a == b)
+			return false;
+
+		if (a < b) {
+			std::swap(a, b);
+		}
+
+		// Fails if another thread linked a in the meantime.
+		std::uint32_t root = a;
+
+		if (parents[a].compare_exchange_weak(root, b, std::memory_order_relaxed))
+			return true;
+	}
+}
+
+// Reports the tiles of a column picked by the bits, one for each row
+// from the first, offset from the row of cells.
+void MazeValidator::ReportRows(Stripe& stripe, MazeRule rule, std::uint64_t bits, int x, int firstRow, int offset)
+{
+	for (; bits != 0; bits &= bits - 1) {
+		Report(stripe, rule, x, 2 * (firstRow + CountTrailingZeros(bits)) + 1 + offset);
+	}
+}
+
+void MazeValidator::Report(Stripe& stripe, MazeRule rule, int x, int y)
+{
+	stripe.counts[static_cast<int>(rule)]++;
+
+	if (stripe.violations.size() < maxReported) {
+		stripe.violations.push_back({ rule, { x, y } });
+	}
+}
+
+void MazeValidator::Report(MazeRule rule, GridPosition position)
+{
+	report.counts[static_cast<int>(rule)]++;
+
+	if (report.violations.size() < maxReported) {
+		report.violations.push_back({ rule, position });
+	}
+}
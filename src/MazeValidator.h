@@ -0,0 +1,131 @@
+#ifndef MAZE_VALIDATOR_H
+#define MAZE_VALIDATOR_H
+
+#include "Maze.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class WorkStealingPool;
+
+// The rules every maze made by MazeGenerator follows.
+enum class MazeRule : std::uint8_t
+{
+	// Both sides are odd and at least 3.
+	Size,
+	// Every cell of the lattice (odd x and odd y) is open.
+	OpenCells,
+	// Every pillar between the cells (even x and even y) is a wall.
+	ClosedPillars,
+	// The border is walled, apart from the exit.
+	ClosedBorder,
+	// There is exactly one exit, on an odd tile of the border, where
+	// the maze says it is.
+	SingleExit,
+	// The tile inside the exit is open.
+	OpenExitNeighbour,
+	// The start is a cell of the lattice.
+	StartOnLattice,
+	// No passage closes a loop.
+	NoCycles,
+	// Every cell can be reached from the start.
+	Connected,
+	// The exit can be reached from the start.
+	ExitReachable,
+	Count
+};
+
+const char* GetRuleName(MazeRule rule);
+
+struct MazeViolation
+{
+	MazeRule rule {MazeRule::Size};
+	GridPosition position;
+};
+
+struct ValidationReport
+{
+	// Every violation of every rule is counted.
+	std::uint64_t counts[static_cast<int>(MazeRule::Count)] {};
+	// The first violations found, up to MazeValidator::maxReported. A
+	// cycle is reported at a passage that closes it, and a disconnected
+	// region at its first cell.
+	std::vector<MazeViolation> violations;
+	// Connected regions of cells.
+	std::uint64_t components {0};
+	// The size of the grid that was scanned.
+	std::uint64_t bytes {0};
+
+	std::uint64_t GetViolationCount() const;
+	bool IsValid() const { return GetViolationCount() == 0; }
+};
+
+// Checks that a maze is perfect: every cell of the lattice is open and
+// the passages between them form a single tree that holds the start
+// and the exit. The grid is scanned in stripes of whole columns, which
+// are contiguous in memory. Every stripe joins the cells it connects in
+// a union-find shared by all stripes: a passage that joins two cells
+// that are already connected closes a cycle, and once the passages
+// between stripes are joined as well, every region that does not hold
+// the start is disconnected. Parents are linked with a compare-and-swap
+// from the larger cell index to the smaller, so stripes on different
+// threads never take a lock. The memory is kept for the next maze.
+class MazeValidator
+{
+	public:
+		// Violations listed in the report at most; all of them are counted.
+		static constexpr std::size_t maxReported = 64;
+		// Columns of cells per stripe.
+		static constexpr int columnsPerStripe = 64;
+
+		// Scans the stripes on the pool if one is given.
+		const ValidationReport& Validate(const Maze& maze, WorkStealingPool* pool = nullptr);
+
+		const ValidationReport& GetReport() const { return report; }
+
+	private:
+		struct Stripe
+		{
+			int firstColumn {0};
+			int endColumn {0};
+			std::uint64_t counts[static_cast<int>(MazeRule::Count)] {};
+			std::vector<MazeViolation> violations;
+			std::vector<GridPosition> exits;
+			std::uint64_t components {0};
+		};
+
+		const Matrix<TileType>* tiles {nullptr};
+		int width {0};
+		int height {0};
+		int columns {0};
+		int rows {0};
+		std::uint32_t startRoot {0};
+
+		// The parent of every cell of the lattice, cell x * rows + y.
+		std::unique_ptr<std::atomic<std::uint32_t>[]> parents;
+		std::size_t parentCapacity {0};
+		std::vector<Stripe> stripes;
+		ValidationReport report;
+
+		void RunStripes(WorkStealingPool* pool, void (MazeValidator::*step)(Stripe&));
+		void ScanStripe(Stripe& stripe);
+		void JoinStripe(Stripe& stripe);
+		void CountComponents(Stripe& stripe);
+		void CheckBorderColumn(Stripe& stripe, int x, bool wallsOnBorder);
+		void CheckBorderTile(Stripe& stripe, int x, int y);
+		void CheckExit(const Maze& maze);
+
+		std::uint32_t Find(std::uint32_t cell);
+		std::uint32_t FindWithinStripe(std::uint32_t cell);
+		// Both return false if the cells were already connected.
+		bool Union(std::uint32_t a, std::uint32_t b);
+		bool UnionWithinStripe(std::uint32_t a, std::uint32_t b);
+
+		void ReportRows(Stripe& stripe, MazeRule rule, std::uint64_t bits, int x, int firstRow, int offset);
+		void Report(Stripe& stripe, MazeRule rule, int x, int y);
+		void Report(MazeRule rule, GridPosition position);
+};
+
+#endif
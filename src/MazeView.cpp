@@ -0,0 +1,227 @@
+#include "MazeView.h"
+#include "Profiler.h"
+#include <SFML/OpenGL.hpp>
+#include <cmath>
+
+// The clear color of the window, under the tiles of the layer.
+static const sf::Color backgroundColor(40, 40, 40);
+// Walls are drawn as lines this wide, centered on the tiles.
+static const float wallWidth = 4.0f;
+
+static sf::Vertex ToVertex(const TileVertex& vertex)
+{
+	return { { vertex.x, vertex.y }, 
+		 { vertex.color.r, vertex.color.g, vertex.color.b, vertex.color.a } };
+}
+
+// Copies the geometry of each chunk into the vertex arrays of its 
+// slot: all of it when the chunk was built, otherwise only the
+// changed vertices. Then draws the chunk with a call per array.
+class ChunkUploader : public TileBatchTarget
+{
+	public:
+		ChunkUploader(sf::RenderTarget& target, sf::RenderStates states, 
+			      std::vector<MazeView::ChunkArrays>& arrays)
+			: target(target), states(states), arrays(arrays) { }
+
+		virtual void DrawChunk(int slot, const TileChunk& chunk)
+		{
+			if (slot >= static_cast<int>(arrays.size())) {
+				arrays.resize(slot + 1);
+			}
+
+			sf::VertexArray& quads = arrays[slot].quads;
+			sf::VertexArray& lines = arrays[slot].lines;
+			std::size_t first = chunk.firstChanged;
+			std::size_t end = chunk.endChanged;
+
+			if (chunk.rebuilt)
+			{
+				quads.resize(chunk.quads.size());
+				lines.resize(chunk.lines.size());
+
+				for (std::size_t i = 0; i < chunk.lines.size(); i++) {
+					lines[i] = ToVertex(chunk.lines[i]);
+				}
+
+				first = 0;
+				end = chunk.quads.size();
+			}
+
+			for (std::size_t i = first; i < end; i++) {
+				quads[i] = ToVertex(chunk.quads[i]);
+			}
+
+			target.draw(quads, states);
+			lineArrays.push_back(&lines);
+		}
+
+		// Walls are drawn over the tiles of every chunk.
+		void DrawLines()
+		{
+			glLineWidth(wallWidth);
+
+			for (const sf::VertexArray* lines : lineArrays) {
+				target.draw(*lines, states);
+			}
+		}
+
+	private:
+		sf::RenderTarget& target;
+		sf::RenderStates states;
+		std::vector<MazeView::ChunkArrays>& arrays;
+		std::vector<const sf::VertexArray*> lineArrays;
+};
+
+static TileColor ToTileColor(sf::Color color)
+{
+	TileColor tileColor;
+	tileColor.r = color.r;
+	tileColor.g = color.g;
+	tileColor.b = color.b;
+	tileColor.a = color.a;
+	return tileColor;
+}
+
+MazeView::MazeView(std::shared_ptr<const Maze> maze, float tileSize)
+	: maze(std::move(maze)), tileSize(tileSize)
+{
+	MAZE_PROFILE_SCOPE("CreateView");
+	Rebuild();
+}
+
+void MazeView::Rebuild()
+{
+	tileBatch.Build(maze->GetTiles(), tileSize, ToTileColor(sf::Color::White), 
+			ToTileColor(sf::Color::Green), maxCachedChunks);
+
+	// Every tile starts out white, so no old solution needs clearing.
+	// Room for a solution through every open tile keeps the next levels
+	// from allocating.
+	solution.clear();
+	solution.reserve(GetOpenTileCount(maze->GetWidth(), maze->GetHeight()));
+	SetSolution();
+	layerCache.Invalidate();
+}
+
+void MazeView::SetTileColor(GridPosition position, sf::Color color)
+{
+	tileBatch.SetColor(position.x, position.y, ToTileColor(color));
+	layerCache.MarkDirty(GetTileRegion(position, wallWidth * 0.5f));
+}
+
+void MazeView::SetSolution()
+{
+	const std::vector<std::uint32_t>& newSolution = maze->GetSolution();
+	solutionCells.resize((static_cast<std::size_t>(maze->GetWidth()) * maze->GetHeight() + 63) / 64);
+
+	for (std::uint32_t index : newSolution) {
+		solutionCells[index / 64] |= std::uint64_t(1) << (index % 64);
+	}
+
+	for (std::uint32_t index : solution)
+	{
+		if ((solutionCells[index / 64] >> (index % 64) & 1) == 0) {
+			SetTileColor(maze->GetPosition(index), sf::Color::White);
+		}
+	}
+
+	TileColor red = ToTileColor(sf::Color::Red);
+
+	for (std::uint32_t index : newSolution)
+	{
+		GridPosition position = maze->GetPosition(index);
+
+		if (tileBatch.GetColor(position.x, position.y) != red) {
+			SetTileColor(position, sf::Color::Red);
+		}
+
+		solutionCells[index / 64] = 0;
+	}
+
+	solution = newSolution;
+
+	// The start is drawn over the solution.
+	SetTileColor(maze->GetStartPosition(), sf::Color::Black);
+}
+
+void MazeView::OnTileChanged(GridPosition position)
+{
+	tileBatch.RebuildTile(position.x, position.y);
+
+	// The walls between the tile and its neighbours changed as well.
+	layerCache.MarkDirty(GetTileRegion(position, tileSize));
+}
+
+ViewRect MazeView::GetTileRegion(GridPosition position, float margin) const
+{
+	ViewRect region;
+	region.left = position.x * tileSize - margin;
+	region.top = position.y * tileSize - margin;
+	region.width = tileSize + 2 * margin;
+	region.height = tileSize + 2 * margin;
+	return region;
+}
+
+void MazeView::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	MAZE_PROFILE_SCOPE("DrawMaze");
+	const sf::View& view = target.getView();
+
+	ViewRect rect;
+	rect.left = view.getCenter().x - view.getSize().x * 0.5f;
+	rect.top = view.getCenter().y - view.getSize().y * 0.5f;
+	rect.width = view.getSize().x;
+	rect.height = view.getSize().y;
+
+	auto layerWidth = static_cast<unsigned int>(std::ceil(rect.width * layerScale));
+	auto layerHeight = static_cast<unsigned int>(std::ceil(rect.height * layerScale));
+
+	if (layer.getSize().x < layerWidth || layer.getSize().y < layerHeight)
+	{
+		// The view grew, e.g. with the window.
+		layer.create(layerWidth, layerHeight);
+		layerCache.Reset(static_cast<float>(layerWidth), static_cast<float>(layerHeight));
+	}
+
+	const std::vector<ViewRect>& regions = layerCache.Update(rect);
+	MAZE_PROFILE_COUNT("LayerRegions", regions.size());
+
+	if (!regions.empty())
+	{
+		for (const ViewRect& region : regions) {
+			DrawRegion(region);
+		}
+
+		layer.display();
+	}
+
+	const ViewRect& bounds = layerCache.GetBounds();
+	sf::Sprite sprite(layer.getTexture());
+	sprite.setTextureRect(sf::IntRect(0, 0, static_cast<int>(bounds.width), static_cast<int>(bounds.height)));
+	sprite.setPosition(bounds.left, bounds.top);
+	target.draw(sprite, states);
+}
+
+// Draws the tiles and walls within a region of the world over the same
+// region of the layer, and nowhere else.
+void MazeView::DrawRegion(const ViewRect& region) const
+{
+	MAZE_PROFILE_SCOPE("DrawLayerRegion");
+	const ViewRect& bounds = layerCache.GetBounds();
+
+	sf::View view(sf::FloatRect(region.left, region.top, region.width, region.height));
+	view.setViewport(sf::FloatRect((region.left - bounds.left) / bounds.width, 
+				       (region.top - bounds.top) / bounds.height,
+				       region.width / bounds.width, region.height / bounds.height));
+	layer.setView(view);
+
+	sf::RectangleShape background({ region.width, region.height });
+	background.setPosition(region.left, region.top);
+	background.setFillColor(backgroundColor);
+	layer.draw(background);
+
+	ChunkUploader uploader(layer, sf::RenderStates::Default, chunkArrays);
+	tileBatch.Draw(region, uploader);
+	uploader.DrawLines();
+}
@@ -0,0 +1,71 @@
+#ifndef MAZE_VIEW_H
+#define MAZE_VIEW_H
+
+#include <SFML\Graphics.hpp>
+#include "Maze.h"
+#include "TileBatch.h"
+#include "LayerCache.h"
+#include <memory>
+
+// Draws a Maze with SFML. The view is built from the grid of
+// a Maze and is only needed when the maze is actually displayed.
+// Tiles have a fixed size in pixels and are drawn in chunks: only the
+// chunks within the view of the render target are built and drawn,
+// and only the vertices of tiles whose color changed are uploaded again.
+// The chunks are not drawn to the target directly but to a layer around
+// the view, which is shown as a single sprite. While the camera stays
+// within the layer and no tile changes, a frame draws nothing else;
+// a changed tile only redraws its own region of the layer.
+class MazeView : public sf::Drawable
+{
+	public:
+		// Chunks whose geometry is kept around at most, unless more are visible.
+		static constexpr std::size_t maxCachedChunks = 256;
+		// The layer is this many times the size of the view on each side.
+		static constexpr float layerScale = 2.0f;
+
+		MazeView(std::shared_ptr<const Maze> maze, float tileSize);
+
+		// Builds the view again after the maze was regenerated in place.
+		// The chunks and vertex arrays of the old maze are reused.
+		void Rebuild();
+
+		void SetTileColor(GridPosition position, sf::Color color);
+
+		// Colors the current solution of the maze, clearing the previous one.
+		// Only tiles that are on one path but not the other are updated.
+		void SetSolution();
+
+		// Redraws the walls around a tile that was opened or closed.
+		void OnTileChanged(GridPosition position);
+
+		float GetTileSize() const { return tileSize; }
+
+	private:
+		friend class ChunkUploader;
+
+		struct ChunkArrays
+		{
+			sf::VertexArray quads {sf::Quads};
+			sf::VertexArray lines {sf::Lines};
+		};
+
+		std::shared_ptr<const Maze> maze;
+		float tileSize;
+		// Drawing builds chunks and uploads pending changes, hence mutable.
+		mutable TileBatch tileBatch;
+		mutable std::vector<ChunkArrays> chunkArrays;
+		std::vector<std::uint32_t> solution;
+		// Cells of the new solution while it replaces the old one; otherwise clear.
+		std::vector<std::uint64_t> solutionCells;
+		mutable sf::RenderTexture layer;
+		mutable LayerCache layerCache;
+
+		// The area of a tile, grown by a margin on every side.
+		ViewRect GetTileRegion(GridPosition position, float margin) const;
+		void DrawRegion(const ViewRect& region) const;
+
+		virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+};
+
+#endif
@@ -0,0 +1,228 @@
+#include "PathIndex.h"
+#include "Profiler.h"
+#include <algorithm>
+
+// Marks cells that are on the stack but not yet numbered.
+static const std::uint32_t queued = PathIndex::unreachable - 1;
+
+// Numbers the cells with an iterative depth-first search from the
+// start. Cells are numbered as they leave the stack, and everything
+// pushed after a cell leaves descends from it, so every subtree ends
+// up with a contiguous range of numbers.
+void PathIndex::Build(const Maze& maze)
+{
+	MAZE_PROFILE_SCOPE("BuildPathIndex");
+
+	int width = maze.GetWidth();
+	int height = maze.GetHeight();
+	const Matrix<TileType>& tiles = maze.GetTiles();
+	std::size_t cellCount = static_cast<std::size_t>(width) * height;
+
+	orders.assign(cellCount, unreachable);
+	cells.clear();
+	depths.clear();
+	parents.clear();
+	stack.clear();
+
+	std::uint32_t start = maze.GetIndex(maze.GetStartPosition());
+	orders[start] = queued;
+	stack.push_back({ start, unreachable });
+
+	while (!stack.empty())
+	{
+		std::uint32_t current = stack.back().first;
+		std::uint32_t parent = stack.back().second;
+		stack.pop_back();
+
+		std::uint32_t order = static_cast<std::uint32_t>(cells.size());
+		orders[current] = order;
+		cells.push_back(current);
+		parents.push_back(parent);
+		depths.push_back(parent == unreachable ? 0 : depths[parent] + 1);
+
+		int x = static_cast<int>(current % width);
+		int y = static_cast<int>(current / width);
+
+		const int offsetsX[4] = { 0, 1, 0, -1 };
+		const int offsetsY[4] = { -1, 0, 1, 0 };
+
+		for (int direction = 0; direction < 4; direction++)
+		{
+			int neighbourX = x + offsetsX[direction];
+			int neighbourY = y + offsetsY[direction];
+
+			if (neighbourX < 0 || neighbourX >= width || neighbourY < 0 || neighbourY >= height ||
+			    tiles(neighbourX, neighbourY) == TileType::Wall)
+				continue;
+
+			std::uint32_t neighbour = static_cast<std::uint32_t>(neighbourY) * width + neighbourX;
+
+			if (orders[neighbour] != unreachable)
+				continue;
+
+			orders[neighbour] = queued;
+			stack.push_back({ neighbour, order });
+		}
+	}
+
+	BuildBlockMinima();
+}
+
+// Level 0 holds the minimum of each block, and every level above holds
+// the minimum of two overlapping or touching entries of the level below.
+void PathIndex::BuildBlockMinima()
+{
+	blockCount = (cells.size() + blockSize - 1) / blockSize;
+
+	levels.assign(blockCount + 1, 0);
+
+	for (std::size_t count = 2; count <= blockCount; count++) {
+		levels[count] = levels[count / 2] + 1;
+	}
+
+	std::size_t levelCount = levels[blockCount] + 1;
+	blockMinima.resize(levelCount * blockCount);
+
+	for (std::size_t block = 0; block < blockCount; block++)
+	{
+		auto first = depths.begin() + block * blockSize;
+		auto end = depths.begin() + std::min((block + 1) * blockSize, depths.size());
+		blockMinima[block] = *std::min_element(first, end);
+	}
+
+	for (std::size_t level = 1; level < levelCount; level++)
+	{
+		const std::uint32_t* below = &blockMinima[(level - 1) * blockCount];
+		std::uint32_t* minima = &blockMinima[level * blockCount];
+		std::size_t half = std::size_t(1) << (level - 1);
+
+		for (std::size_t block = 0; block + 2 * half <= blockCount; block++) {
+			minima[block] = std::min(below[block], below[block + half]);
+		}
+	}
+}
+
+// The minimum depth between two depth-first numbers, both included.
+std::uint32_t PathIndex::GetMinimumDepth(std::uint32_t first, std::uint32_t last) const
+{
+	std::size_t firstBlock = first / blockSize;
+	std::size_t lastBlock = last / blockSize;
+	const std::uint32_t* values = depths.data();
+
+	if (firstBlock == lastBlock)
+		return *std::min_element(values + first, values + last + 1);
+
+	std::uint32_t minimum = std::min(*std::min_element(values + first, values + (firstBlock + 1) * blockSize),
+	                                 *std::min_element(values + lastBlock * blockSize, values + last + 1));
+
+	if (lastBlock > firstBlock + 1)
+	{
+		std::size_t count = lastBlock - firstBlock - 1;
+		std::size_t level = levels[count];
+		const std::uint32_t* minima = &blockMinima[level * blockCount];
+
+		minimum = std::min(minimum, std::min(minima[firstBlock + 1], minima[lastBlock - (std::size_t(1) << level)]));
+	}
+
+	return minimum;
+}
+
+// Past the first of the two numbers, the shallowest cells up to the
+// second are children of the common ancestor, one level below it.
+std::uint32_t PathIndex::GetDistance(std::uint32_t from, std::uint32_t to) const
+{
+	std::uint32_t first = orders[from];
+	std::uint32_t last = orders[to];
+
+	if (first == unreachable || last == unreachable)
+		return unreachable;
+
+	if (first == last)
+		return 0;
+
+	if (first > last) {
+		std::swap(first, last);
+	}
+
+	std::uint32_t commonDepth = GetMinimumDepth(first + 1, last) - 1;
+	return depths[first] + depths[last] - 2 * commonDepth;
+}
+
+// Both cells climb their parents up to the depth of the common
+// ancestor. The climb from the second cell is reversed onto the end.
+void PathIndex::GetPath(std::uint32_t from, std::uint32_t to, std::vector<std::uint32_t>& path) const
+{
+	path.clear();
+
+	std::uint32_t current = orders[from];
+	std::uint32_t other = orders[to];
+
+	if (current == unreachable || other == unreachable)
+		return;
+
+	std::uint32_t commonDepth = depths[current];
+
+	if (current != other) {
+		commonDepth = GetMinimumDepth(std::min(current, other) + 1, std::max(current, other)) - 1;
+	}
+
+	while (depths[current] > commonDepth)
+	{
+		path.push_back(cells[current]);
+		current = parents[current];
+	}
+
+	path.push_back(cells[current]);
+	std::size_t middle = path.size();
+
+	while (depths[other] > commonDepth)
+	{
+		path.push_back(cells[other]);
+		other = parents[other];
+	}
+
+	std::reverse(path.begin() + middle, path.end());
+}
+
+void PathIndex::GetDistances(const std::vector<PathQuery>& queries, std::vector<std::uint32_t>& distances,
+                             WorkStealingPool* pool) const
+{
+	MAZE_PROFILE_SCOPE("PathQueries");
+
+	distances.resize(queries.size());
+	std::size_t taskCount = (queries.size() + queriesPerTask - 1) / queriesPerTask;
+
+	if (pool == nullptr || taskCount <= 1) {
+		GetDistancesRange(queries.data(), distances.data(), queries.size());
+	}
+	else
+	{
+		// Each task writes only its own answers.
+		for (std::size_t task = 0; task < taskCount; task++)
+		{
+			pool->Submit([&, task](int)
+			{
+				std::size_t first = task * queriesPerTask;
+				std::size_t count = std::min(queriesPerTask, queries.size() - first);
+				GetDistancesRange(queries.data() + first, distances.data() + first, count);
+			});
+		}
+
+		pool->Wait();
+	}
+
+	MAZE_PROFILE_COUNT("PathQueries", queries.size());
+}
+
+void PathIndex::GetDistancesRange(const PathQuery* queries, std::uint32_t* distances, std::size_t count) const
+{
+	for (std::size_t i = 0; i < count; i++) {
+		distances[i] = GetDistance(queries[i].from, queries[i].to);
+	}
+}
+
+std::size_t PathIndex::GetMemoryBytes() const
+{
+	return (orders.size() + cells.size() + depths.size() + parents.size() + blockMinima.size()) * sizeof(std::uint32_t) +
+	       levels.size();
+}
@@ -0,0 +1,79 @@
+#ifndef PATH_INDEX_H
+#define PATH_INDEX_H
+
+#include "Maze.h"
+#include "WorkStealingPool.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// A query for the distance between two cells.
+struct PathQuery
+{
+	std::uint32_t from {0};
+	std::uint32_t to {0};
+};
+
+// Answers the distance and the path between any two cells of a
+// perfect maze. The open cells form a tree, which is rooted at the
+// start and numbered in depth-first order, so that every subtree is
+// a contiguous range of numbers. Between the numbers of two cells,
+// the shallowest cells are children of their lowest common ancestor,
+// so a distance is a minimum over a range of depths: the depths are
+// split into blocks, the minimum of whole blocks comes from a sparse
+// table and the blocks at either end are scanned.
+// Cells are identified by their index y * width + x, like in Maze.
+// In a maze with loops, the distances are along a spanning tree and
+// may be longer than the shortest path.
+class PathIndex
+{
+	public:
+		static constexpr std::uint32_t unreachable = 0xFFFFFFFF;
+		// Depths per block of the range minimum. Queries scan at most
+		// two blocks.
+		static constexpr std::size_t blockSize = 16;
+		// Queries per task when answering a batch on a pool.
+		static constexpr std::size_t queriesPerTask = 1 << 14;
+
+		void Build(const Maze& maze);
+
+		// The number of steps between two cells, or unreachable if
+		// either cell is a wall or cut off from the start.
+		std::uint32_t GetDistance(std::uint32_t from, std::uint32_t to) const;
+
+		// The cells from one cell to the other, both included, or an
+		// empty path if there is none.
+		void GetPath(std::uint32_t from, std::uint32_t to, std::vector<std::uint32_t>& path) const;
+
+		// Answers every query of a batch, on the pool if one is given.
+		void GetDistances(const std::vector<PathQuery>& queries, std::vector<std::uint32_t>& distances,
+		                  WorkStealingPool* pool = nullptr) const;
+
+		// The number of cells in the tree.
+		std::size_t GetTreeSize() const { return cells.size(); }
+		std::size_t GetMemoryBytes() const;
+
+	private:
+		// Indexed by cell: the number of the cell in depth-first order.
+		std::vector<std::uint32_t> orders;
+		// Indexed by depth-first number: the cell, its distance from
+		// the start and the number of its parent.
+		std::vector<std::uint32_t> cells;
+		std::vector<std::uint32_t> depths;
+		std::vector<std::uint32_t> parents;
+
+		// The minimum depth of 2^level blocks starting at each block,
+		// one level after another.
+		std::vector<std::uint32_t> blockMinima;
+		std::vector<std::uint8_t> levels;
+		std::size_t blockCount {0};
+
+		// Cells found but not yet numbered, with the number of their parent.
+		std::vector<std::pair<std::uint32_t, std::uint32_t>> stack;
+
+		void BuildBlockMinima();
+		std::uint32_t GetMinimumDepth(std::uint32_t first, std::uint32_t last) const;
+		void GetDistancesRange(const PathQuery* queries, std::uint32_t* distances, std::size_t count) const;
+};
+
+#endif
@@ -67,6 +67,13 @@ void Player::GotoStart()
 	SetPosition(pos.x, pos.y);
 }
 
+// The center of the player in world coordinates, followed by the camera.
+sf::Vector2f Player::GetCenter() const
+{
+	auto size = rectangle.getSize();
+	return rectangle.getPosition() + size * 0.5f;
+}
+
 void Player::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
 	target.draw(rectangle);
@@ -14,6 +14,7 @@ class Player : public sf::Drawable
 		void SetPosition(int x, int y);
 		void SetMaze(const std::shared_ptr<Maze>& maze);
 		void GotoStart();
+		sf::Vector2f GetCenter() const;
 	private:
 		int X {0};
 		int Y {0};
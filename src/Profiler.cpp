@@ -0,0 +1,253 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+void ProfileStats::Record(const char* name, std::uint64_t nanoseconds)
+{
+	if (Entry* entry = Get(name))
+	{
+		entry->nanoseconds += nanoseconds;
+		entry->calls++;
+	}
+}
+
+void ProfileStats::Count(const char* name, std::uint64_t value)
+{
+	if (Entry* entry = Get(name)) {
+		entry->count += value;
+	}
+}
+
+// Names are string literals, so the pointer usually matches; the
+// same literal may still have different addresses in different
+// translation units, hence the fallback to comparing the text.
+const ProfileStats::Entry* ProfileStats::Find(const char* name) const
+{
+	for (int i = 0; i < entryCount; i++)
+	{
+		if (entries[i].name == name || std::strcmp(entries[i].name, name) == 0)
+			return &entries[i];
+	}
+
+	return nullptr;
+}
+
+std::uint64_t ProfileStats::GetNanoseconds(const char* name) const
+{
+	const Entry* entry = Find(name);
+	return entry ? entry->nanoseconds : 0;
+}
+
+std::uint64_t ProfileStats::GetCount(const char* name) const
+{
+	const Entry* entry = Find(name);
+	return entry ? entry->count : 0;
+}
+
+// Returns the entry of the name, adding it if there is room.
+ProfileStats::Entry* ProfileStats::Get(const char* name)
+{
+	if (const Entry* entry = Find(name))
+		return const_cast<Entry*>(entry);
+
+	if (entryCount == maxEntries)
+		return nullptr;
+
+	Entry& entry = entries[entryCount++];
+	entry = Entry();
+	entry.name = name;
+	return &entry;
+}
+
+FrameStats::FrameStats() : lastMark(std::chrono::steady_clock::now())
+{
+	std::memset(frames, 0, sizeof(frames));
+}
+
+void FrameStats::Mark(FrameStage stage)
+{
+	auto now = std::chrono::steady_clock::now();
+	int index = static_cast<int>(stage);
+
+	frames[latest][index] = std::chrono::duration_cast<std::chrono::nanoseconds>(now - lastMark).count();
+	lastMark = now;
+
+	if (index == stageCount - 1)
+	{
+		latest = (latest + 1) % frameCount;
+		recordedFrames = std::min(recordedFrames + 1, frameCount);
+		std::fill(frames[latest], frames[latest] + stageCount, 0);
+	}
+}
+
+std::uint64_t FrameStats::GetNanoseconds(int framesAgo, FrameStage stage) const
+{
+	int frame = (latest - 1 - framesAgo + 2 * frameCount) % frameCount;
+	return frames[frame][static_cast<int>(stage)];
+}
+
+std::uint64_t FrameStats::GetFrameNanoseconds(int framesAgo) const
+{
+	std::uint64_t total = 0;
+
+	for (int stage = 0; stage < stageCount; stage++) {
+		total += GetNanoseconds(framesAgo, static_cast<FrameStage>(stage));
+	}
+
+	return total;
+}
+
+std::uint64_t FrameStats::GetPercentile(FrameStage stage, double percentile) const
+{
+	if (recordedFrames == 0)
+		return 0;
+
+	std::uint64_t times[frameCount];
+
+	for (int i = 0; i < recordedFrames; i++) {
+		times[i] = GetNanoseconds(i, stage);
+	}
+
+	int rank = static_cast<int>(percentile / 100.0 * (recordedFrames - 1) + 0.5);
+	rank = std::max(0, std::min(rank, recordedFrames - 1));
+
+	std::nth_element(times, times + rank, times + recordedFrames);
+	return times[rank];
+}
+
+void FrameStats::GetHistogram(FrameStage stage, int* buckets) const
+{
+	std::fill(buckets, buckets + bucketCount, 0);
+
+	for (int i = 0; i < recordedFrames; i++)
+	{
+		std::uint64_t quarters = GetNanoseconds(i, stage) / 250000;
+		int bucket = 0;
+
+		while (quarters > 0 && bucket < bucketCount - 1)
+		{
+			quarters >>= 1;
+			bucket++;
+		}
+
+		buckets[bucket]++;
+	}
+}
+
+namespace
+{
+	struct TraceEvent
+	{
+		const char* name;
+		std::int64_t begin;
+		std::int64_t duration;
+		int thread;
+	};
+
+	const std::size_t maxTraceEvents = 1 << 20;
+
+	thread_local ProfileStats* threadStats = nullptr;
+	std::atomic<bool> tracing(false);
+	std::atomic<int> threadCount(0);
+	std::mutex traceMutex;
+	std::vector<TraceEvent> traceEvents;
+	const auto traceStart = std::chrono::steady_clock::now();
+
+	int GetThreadNumber()
+	{
+		thread_local int number = threadCount++;
+		return number;
+	}
+}
+
+void Profiler::SetThreadStats(ProfileStats* stats)
+{
+	threadStats = stats;
+}
+
+ProfileStats* Profiler::GetThreadStats()
+{
+	return threadStats;
+}
+
+void Profiler::Count(const char* name, std::uint64_t value)
+{
+	if (threadStats != nullptr) {
+		threadStats->Count(name, value);
+	}
+}
+
+void Profiler::SetTracing(bool enabled)
+{
+	tracing = enabled;
+}
+
+bool Profiler::IsTracing()
+{
+	return tracing.load(std::memory_order_relaxed);
+}
+
+void Profiler::AddTraceEvent(const char* name, std::chrono::steady_clock::time_point begin,
+			     std::chrono::steady_clock::time_point end)
+{
+	using namespace std::chrono;
+
+	TraceEvent event;
+	event.name = name;
+	event.begin = duration_cast<nanoseconds>(begin - traceStart).count();
+	event.duration = duration_cast<nanoseconds>(end - begin).count();
+	event.thread = GetThreadNumber();
+
+	std::lock_guard<std::mutex> lock(traceMutex);
+
+	if (traceEvents.size() < maxTraceEvents) {
+		traceEvents.push_back(event);
+	}
+}
+
+// Complete events ("ph": "X") with times in microseconds.
+bool Profiler::WriteChromeTrace(const char* path)
+{
+	std::FILE* file = std::fopen(path, "w");
+
+	if (file == nullptr)
+		return false;
+
+	std::lock_guard<std::mutex> lock(traceMutex);
+	std::fprintf(file, "{\"traceEvents\": [\n");
+
+	for (std::size_t i = 0; i < traceEvents.size(); i++)
+	{
+		const TraceEvent& event = traceEvents[i];
+
+		std::fprintf(file, "{\"name\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+		             "\"pid\": 1, \"tid\": %d}%s\n", event.name, event.begin / 1000.0,
+		             event.duration / 1000.0, event.thread, (i + 1 < traceEvents.size()) ? "," : "");
+	}
+
+	std::fprintf(file, "],\n\"displayTimeUnit\": \"ms\"}\n");
+	return std::fclose(file) == 0;
+}
+
+FrameStats& Profiler::GetFrameStats()
+{
+	static FrameStats frameStats;
+	return frameStats;
+}
+
+ScopedTimer::~ScopedTimer()
+{
+	auto end = std::chrono::steady_clock::now();
+
+	if (ProfileStats* stats = Profiler::GetThreadStats()) {
+		stats->Record(name, std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+	}
+
+	if (Profiler::IsTracing()) {
+		Profiler::AddTraceEvent(name, begin, end);
+	}
+}
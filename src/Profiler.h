@@ -0,0 +1,158 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Instrumentation is compiled in only when MAZE_ENABLE_PROFILING is
+// defined. Otherwise the macros below expand to nothing, so the
+// instrumented code pays nothing at all.
+//
+// MAZE_PROFILE_SCOPE(name)         times the rest of the enclosing scope.
+// MAZE_PROFILE_COUNT(name, value)  adds to a counter.
+// MAZE_PROFILE_FRAME(stage)        ends a stage of the current frame.
+//
+// Names must be string literals. Timings and counters go to the
+// ProfileStats the calling thread is collecting into, if any, and
+// timings also go to the trace when tracing is enabled.
+#ifdef MAZE_ENABLE_PROFILING
+#define MAZE_PROFILE_JOIN2(a, b) a##b
+#define MAZE_PROFILE_JOIN(a, b) MAZE_PROFILE_JOIN2(a, b)
+#define MAZE_PROFILE_SCOPE(name) ScopedTimer MAZE_PROFILE_JOIN(profileScope, __LINE__)(name)
+#define MAZE_PROFILE_COUNT(name, value) Profiler::Count(name, value)
+#define MAZE_PROFILE_FRAME(stage) Profiler::GetFrameStats().Mark(stage)
+#else
+#define MAZE_PROFILE_SCOPE(name) ((void)0)
+#define MAZE_PROFILE_COUNT(name, value) ((void)0)
+#define MAZE_PROFILE_FRAME(stage) ((void)0)
+#endif
+
+// Timings and counters by name, e.g. for everything that went into
+// making a level.
+class ProfileStats
+{
+	public:
+		static constexpr int maxEntries = 32;
+
+		struct Entry
+		{
+			const char* name {nullptr};
+			std::uint64_t nanoseconds {0};
+			std::uint64_t calls {0};
+			std::uint64_t count {0};
+		};
+
+		void Record(const char* name, std::uint64_t nanoseconds);
+		void Count(const char* name, std::uint64_t value);
+		void Clear() { entryCount = 0; }
+
+		// Returns nullptr if nothing was recorded under the name.
+		const Entry* Find(const char* name) const;
+		std::uint64_t GetNanoseconds(const char* name) const;
+		std::uint64_t GetCount(const char* name) const;
+
+		const Entry* begin() const { return entries; }
+		const Entry* end() const { return entries + entryCount; }
+
+	private:
+		Entry entries[maxEntries];
+		int entryCount {0};
+
+		Entry* Get(const char* name);
+};
+
+// Stages of a frame in the main loop, in order.
+enum class FrameStage { Input, Update, Draw, Display, Count };
+
+// Stage times of the latest frames, in a ring buffer.
+class FrameStats
+{
+	public:
+		static constexpr int frameCount = 256;
+		static constexpr int stageCount = static_cast<int>(FrameStage::Count);
+		// Histogram buckets double in width: [0, 0.25) ms, [0.25, 0.5) ms, ...
+		static constexpr int bucketCount = 12;
+
+		FrameStats();
+
+		// Ends the given stage: the time since the previous stage ended
+		// is recorded for it. Ending the last stage ends the frame.
+		void Mark(FrameStage stage);
+
+		// The time of a stage in a frame, with 0 being the latest frame.
+		std::uint64_t GetNanoseconds(int framesAgo, FrameStage stage) const;
+		std::uint64_t GetFrameNanoseconds(int framesAgo) const;
+		int GetRecordedFrames() const { return recordedFrames; }
+
+		// The given percentile (0-100) of a stage over the recorded frames.
+		std::uint64_t GetPercentile(FrameStage stage, double percentile) const;
+		void GetHistogram(FrameStage stage, int* buckets) const;
+
+	private:
+		std::uint64_t frames[frameCount][stageCount];
+		int latest {0};
+		int recordedFrames {0};
+		std::chrono::steady_clock::time_point lastMark;
+};
+
+// Collects scoped timings into per-thread stats and into a trace
+// that can be exported for chrome://tracing or Perfetto.
+namespace Profiler
+{
+	// Timings and counters of the calling thread go to these stats
+	// until they are replaced; nullptr stops collecting.
+	void SetThreadStats(ProfileStats* stats);
+	ProfileStats* GetThreadStats();
+
+	void Count(const char* name, std::uint64_t value);
+
+	// Tracing keeps every timed scope, up to a fixed number of events.
+	void SetTracing(bool enabled);
+	bool IsTracing();
+	void AddTraceEvent(const char* name, std::chrono::steady_clock::time_point begin,
+			   std::chrono::steady_clock::time_point end);
+
+	// Writes the trace in the Chrome trace event format. Returns false
+	// if the file could not be written.
+	bool WriteChromeTrace(const char* path);
+
+	FrameStats& GetFrameStats();
+}
+
+// Times a scope into the thread's stats and the trace.
+class ScopedTimer
+{
+	public:
+		explicit ScopedTimer(const char* name) 
+			: name(name), begin(std::chrono::steady_clock::now()) { }
+		~ScopedTimer();
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+		const char* name;
+		std::chrono::steady_clock::time_point begin;
+};
+
+// Collects into the given stats for the lifetime of the scope, and 
+// restores whatever the thread was collecting into before.
+class ProfileStatsScope
+{
+	public:
+		explicit ProfileStatsScope(ProfileStats& stats) : previous(Profiler::GetThreadStats())
+		{
+			Profiler::SetThreadStats(&stats);
+		}
+
+		~ProfileStatsScope()
+		{
+			Profiler::SetThreadStats(previous);
+		}
+
+	private:
+		ProfileStats* previous;
+};
+
+#endif
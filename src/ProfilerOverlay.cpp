@@ -0,0 +1,60 @@
+#include "ProfilerOverlay.h"
+#include <algorithm>
+
+// Pixels per millisecond and per frame.
+static const float pixelsPerMillisecond = 2.0f;
+static const float barWidth = 2.0f;
+
+static const sf::Color stageColors[FrameStats::stageCount] = {
+	sf::Color(80, 160, 255),  // Input
+	sf::Color(255, 200, 40),  // Update
+	sf::Color(240, 80, 80),   // Draw
+	sf::Color(120, 120, 120)  // Display, including the wait for the frame limit
+};
+
+ProfilerOverlay::ProfilerOverlay(sf::Vector2f position, float budgetMilliseconds)
+	: position(position), budgetMilliseconds(budgetMilliseconds), bars(sf::Quads)
+{
+}
+
+// Frames are drawn from the oldest on the left to the latest on the right,
+// with the stages stacked upwards from the bottom of the overlay.
+void ProfilerOverlay::Update(const FrameStats& frameStats)
+{
+	int frames = std::min(shownFrames, frameStats.GetRecordedFrames());
+	float bottom = position.y + 2.0f * budgetMilliseconds * pixelsPerMillisecond;
+
+	bars.clear();
+
+	for (int i = 0; i < frames; i++)
+	{
+		float left = position.x + (shownFrames - 1 - i) * barWidth;
+		float top = bottom;
+
+		for (int stage = 0; stage < FrameStats::stageCount; stage++)
+		{
+			std::uint64_t nanoseconds = frameStats.GetNanoseconds(i, static_cast<FrameStage>(stage));
+			float height = nanoseconds / 1000000.0f * pixelsPerMillisecond;
+			float base = top;
+			top = std::max(position.y, top - height);
+
+			bars.append({ { left, top }, stageColors[stage] });
+			bars.append({ { left + barWidth, top }, stageColors[stage] });
+			bars.append({ { left + barWidth, base }, stageColors[stage] });
+			bars.append({ { left, base }, stageColors[stage] });
+		}
+	}
+
+	float budget = bottom - budgetMilliseconds * pixelsPerMillisecond;
+	float right = position.x + shownFrames * barWidth;
+
+	bars.append({ { position.x, budget - 1.0f }, sf::Color::White });
+	bars.append({ { right, budget - 1.0f }, sf::Color::White });
+	bars.append({ { right, budget }, sf::Color::White });
+	bars.append({ { position.x, budget }, sf::Color::White });
+}
+
+void ProfilerOverlay::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+	target.draw(bars, states);
+}
@@ -0,0 +1,28 @@
+#ifndef PROFILER_OVERLAY_H
+#define PROFILER_OVERLAY_H
+
+#include <SFML\Graphics.hpp>
+#include "Profiler.h"
+
+// Draws the latest frames of a FrameStats as stacked bars, one column
+// per frame and one color per stage, with a line at the frame budget.
+// Meant to be drawn in screen coordinates, over everything else.
+class ProfilerOverlay : public sf::Drawable
+{
+	public:
+		ProfilerOverlay(sf::Vector2f position, float budgetMilliseconds);
+
+		// Rebuilds the bars from the stats.
+		void Update(const FrameStats& frameStats);
+
+	private:
+		static constexpr int shownFrames = 120;
+
+		sf::Vector2f position;
+		float budgetMilliseconds;
+		sf::VertexArray bars;
+
+		virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+};
+
+#endif
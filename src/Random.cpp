@@ -0,0 +1,46 @@
+#include "Random.h"
+
+// Advances the state by 2^128 steps.
+void Xoshiro256::Jump()
+{
+	static const std::uint64_t jump[] = 
+	{ 
+		0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 
+		0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull 
+	};
+
+	std::uint64_t s0 = 0;
+	std::uint64_t s1 = 0;
+	std::uint64_t s2 = 0;
+	std::uint64_t s3 = 0;
+
+	for (int i = 0; i < 4; i++)
+	{
+		for (int b = 0; b < 64; b++)
+		{
+			if (jump[i] & (1ull << b))
+			{
+				s0 ^= state[0];
+				s1 ^= state[1];
+				s2 ^= state[2];
+				s3 ^= state[3];
+			}
+
+			(*this)();
+		}
+	}
+
+	state[0] = s0;
+	state[1] = s1;
+	state[2] = s2;
+	state[3] = s3;
+}
+
+// Returns an engine continuing from the current state and moves this
+// engine 2^128 steps ahead, so the two streams never overlap.
+Xoshiro256 Xoshiro256::Split()
+{
+	Xoshiro256 stream = *this;
+	Jump();
+	return stream;
+}
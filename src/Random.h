@@ -0,0 +1,107 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// xoshiro256** by David Blackman and Sebastiano Vigna.
+// A small and fast engine with a period of 2^256 - 1. Jump() advances
+// the state by 2^128 steps, which is used to split the engine into
+// independent streams (e.g. one per thread). Seeding and drawing
+// numbers are constexpr, so mazes can be generated at compile time.
+// For more information: http://prng.di.unimi.it/.
+class Xoshiro256
+{
+	public:
+		typedef std::uint64_t result_type;
+
+		explicit constexpr Xoshiro256(std::uint64_t seed = 0) { Seed(seed); }
+
+		// Expands a single 64-bit seed into the full state with SplitMix64,
+		// as recommended by the authors. The state is never all zeroes.
+		constexpr void Seed(std::uint64_t seed)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				seed += 0x9E3779B97F4A7C15ull;
+				std::uint64_t z = seed;
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+				state[i] = z ^ (z >> 31);
+			}
+		}
+
+		void Jump();
+		Xoshiro256 Split();
+
+		constexpr result_type operator()()
+		{
+			const std::uint64_t result = RotateLeft(state[1] * 5, 7) * 9;
+			const std::uint64_t t = state[1] << 17;
+
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = RotateLeft(state[3], 45);
+
+			return result;
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT64_MAX; }
+
+	private:
+		std::uint64_t state[4] {};
+
+		static constexpr std::uint64_t RotateLeft(std::uint64_t x, int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+};
+
+// The engine used by the generators. Any engine with the same
+// interface (Seed, Split and a 64-bit operator()) can be used instead.
+typedef Xoshiro256 RandomEngine;
+
+// Returns a uniformly distributed number in [0, bound) without
+// modulo bias, using Lemire's multiply-and-reject method. Only the
+// upper 32 bits of the engine output are used.
+template <class Engine>
+constexpr std::uint32_t RandomBelow(Engine& engine, std::uint32_t bound)
+{
+	std::uint64_t product = (engine() >> 32) * bound;
+	std::uint32_t low = static_cast<std::uint32_t>(product);
+
+	if (low < bound)
+	{
+		std::uint32_t threshold = (0u - bound) % bound;
+
+		while (low < threshold)
+		{
+			product = (engine() >> 32) * bound;
+			low = static_cast<std::uint32_t>(product);
+		}
+	}
+
+	return static_cast<std::uint32_t>(product >> 32);
+}
+
+// Shuffles a range with the Fisher-Yates algorithm. Unlike std::shuffle
+// the result does not depend on the standard library implementation,
+// so a seed gives the same order on every platform.
+template <class Engine, class Iterator>
+void RandomShuffle(Engine& engine, Iterator first, Iterator last)
+{
+	auto count = last - first;
+
+	for (auto i = count - 1; i > 0; i--)
+	{
+		auto j = RandomBelow(engine, static_cast<std::uint32_t>(i + 1));
+		auto temp = first[i];
+		first[i] = first[j];
+		first[j] = temp;
+	}
+}
+
+#endif
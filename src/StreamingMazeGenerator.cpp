@@ -0,0 +1,221 @@
+#include "StreamingMazeGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <assert.h>
+
+StreamingMazeGenerator::StreamingMazeGenerator(std::uint64_t seed) : seedSequence(seed)
+{
+}
+
+StreamedMaze StreamingMazeGenerator::Generate(int width, int height, const RowSink& sink)
+{
+	return Generate(width, height, seedSequence(), sink);
+}
+
+// Width and Height must be odd numbers. Every lattice row produces
+// two rows of tiles: the row of cells with the passages between them,
+// followed by a row of walls with the passages down to the next row.
+StreamedMaze StreamingMazeGenerator::Generate(int width, int height, std::uint64_t seed, 
+					      const RowSink& sink)
+{
+	assert(width % 2 == 1 && height % 2 == 1);
+	assert(width >= 3 && height >= 3);
+
+	using namespace std::chrono;
+	auto begin = steady_clock::now();
+
+	this->width = width;
+	this->height = height;
+	random.Seed(seed);
+	randomBitCount = 0;
+
+	StreamedMaze maze;
+	maze.width = width;
+	maze.height = height;
+	maze.seed = seed;
+	maze.startPosition = RandomStartPosition();
+	maze.exitPosition = RandomExitPosition();
+
+	GridPosition exit = maze.exitPosition;
+	int columns = (width - 1) / 2;
+	int rows = (height - 1) / 2;
+
+	cellRow.assign(width, TileType::Wall);
+	wallRow.assign(width, TileType::Wall);
+	sets.assign(columns, 0);
+	parents.resize(columns + 1);
+	counts.resize(columns + 1);
+	hasDown.resize(columns + 1);
+	used.resize(columns + 1);
+
+	// The top border.
+	if (exit.y == 0) {
+		wallRow[exit.x] = TileType::Exit;
+	}
+
+	sink(0, wallRow.data(), width);
+
+	for (int row = 0; row < rows; row++)
+	{
+		bool lastRow = (row == rows - 1);
+		int y = 2 * row + 1;
+
+		std::fill(cellRow.begin(), cellRow.end(), TileType::Wall);
+		std::fill(wallRow.begin(), wallRow.end(), TileType::Wall);
+
+		AssignSets();
+		JoinRow(lastRow);
+
+		if (!lastRow) {
+			CarveDown();
+		}
+
+		if (exit.y == y) {
+			cellRow[exit.x] = TileType::Exit;
+		}
+		else if (exit.y == y + 1) {
+			wallRow[exit.x] = TileType::Exit;
+		}
+
+		sink(y, cellRow.data(), width);
+		sink(y + 1, wallRow.data(), width);
+	}
+
+	maze.nanoseconds = duration_cast<nanoseconds>(steady_clock::now() - begin).count();
+
+	return maze;
+}
+
+// Gives every cell that did not inherit a set from the row above
+// a set of its own. There are never more sets than cells in a row,
+// so labels are recycled from the ones no longer in use.
+void StreamingMazeGenerator::AssignSets()
+{
+	std::fill(used.begin(), used.end(), 0);
+
+	for (std::uint32_t set : sets) {
+		used[set] = 1;
+	}
+
+	std::uint32_t freeSet = 1;
+
+	for (std::uint32_t& set : sets)
+	{
+		if (set != 0)
+			continue;
+
+		while (used[freeSet]) {
+			freeSet++;
+		}
+
+		set = freeSet;
+		used[freeSet] = 1;
+	}
+}
+
+// Randomly joins adjacent cells that belong to different sets.
+// On the last row every such pair is joined, which connects the maze.
+void StreamingMazeGenerator::JoinRow(bool lastRow)
+{
+	int columns = static_cast<int>(sets.size());
+
+	for (int set = 0; set <= columns; set++) {
+		parents[set] = set;
+	}
+
+	cellRow[1] = TileType::Path;
+
+	for (int column = 0; column < columns - 1; column++)
+	{
+		std::uint32_t left = FindSet(sets[column]);
+		std::uint32_t right = FindSet(sets[column + 1]);
+
+		if (left != right && (lastRow || RandomBit()))
+		{
+			parents[right] = left;
+			cellRow[2 * column + 2] = TileType::Path;
+		}
+
+		cellRow[2 * column + 3] = TileType::Path;
+	}
+
+	for (std::uint32_t& set : sets) {
+		set = FindSet(set);
+	}
+}
+
+// Randomly carves passages down to the next row, at least one for
+// every set so that no set is cut off. Cells without a passage down
+// start the next row without a set.
+void StreamingMazeGenerator::CarveDown()
+{
+	for (std::uint32_t set : sets)
+	{
+		counts[set] = 0;
+		hasDown[set] = 0;
+	}
+
+	for (std::uint32_t set : sets) {
+		counts[set]++;
+	}
+
+	for (std::size_t column = 0; column < sets.size(); column++)
+	{
+		std::uint32_t set = sets[column];
+		bool lastOfSet = (--counts[set] == 0);
+
+		if (RandomBit() || (lastOfSet && !hasDown[set]))
+		{
+			hasDown[set] = 1;
+			wallRow[2 * column + 1] = TileType::Path;
+		}
+		else
+		{
+			sets[column] = 0;
+		}
+	}
+}
+
+std::uint32_t StreamingMazeGenerator::FindSet(std::uint32_t set)
+{
+	while (parents[set] != set)
+	{
+		parents[set] = parents[parents[set]];
+		set = parents[set];
+	}
+
+	return set;
+}
+
+// Coin flips are taken one bit at a time from the engine.
+bool StreamingMazeGenerator::RandomBit()
+{
+	if (randomBitCount == 0)
+	{
+		randomBits = random();
+		randomBitCount = 64;
+	}
+
+	bool bit = randomBits & 1;
+	randomBits >>= 1;
+	randomBitCount--;
+
+	return bit;
+}
+
+// Works like MazeGenerator: the start is a random odd cell.
+GridPosition StreamingMazeGenerator::RandomStartPosition()
+{
+	int x = 1 + 2 * RandomBelow(random, (width - 1) / 2);
+	int y = 1 + 2 * RandomBelow(random, (height - 1) / 2);
+
+	return { x, y };
+}
+
+// Works like MazeGenerator: the exit is at a random odd position
+// of the border, so the tile next to it is always a carved cell.
+GridPosition StreamingMazeGenerator::RandomExitPosition()
+{
+	int index = static_cast<int>(RandomBelow(random, GetExitCount(width, height)));
+	return GetExitPosition(index, width, height);
+}
@@ -0,0 +1,69 @@
+#ifndef STREAMING_MAZE_GENERATOR_H
+#define STREAMING_MAZE_GENERATOR_H
+
+#include "Grid.h"
+#include "Random.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Receives the rows of a streamed maze from top to bottom.
+// The row is only valid for the duration of the call.
+typedef std::function<void(int y, const TileType* row, int width)> RowSink;
+
+// Describes a maze that was streamed to a sink.
+struct StreamedMaze
+{
+	int width {0};
+	int height {0};
+	GridPosition startPosition;
+	GridPosition exitPosition;
+	std::uint64_t seed {0};
+	std::uint64_t nanoseconds {0};
+
+	double GetRowsPerSecond() const
+	{
+		return nanoseconds > 0 ? height * 1e9 / nanoseconds : 0.0;
+	}
+};
+
+// Generates a perfect maze one row at a time with Eller's algorithm.
+// Only the set labels of the current row are kept, so memory depends
+// on the width of the maze but not on its height, and arbitrarily tall
+// mazes can be written to a file or a pipe as they are generated.
+// For more information: http://www.neocomputer.org/projects/eller.html.
+class StreamingMazeGenerator
+{
+	public:
+		explicit StreamingMazeGenerator(std::uint64_t seed = 0);
+
+		StreamedMaze Generate(int width, int height, const RowSink& sink);
+		StreamedMaze Generate(int width, int height, std::uint64_t seed, const RowSink& sink);
+
+	private:
+		RandomEngine seedSequence;
+		RandomEngine random;
+		std::uint64_t randomBits {0};
+		int randomBitCount {0};
+		int width {0};
+		int height {0};
+
+		std::vector<TileType> cellRow;
+		std::vector<TileType> wallRow;
+		std::vector<std::uint32_t> sets;
+		std::vector<std::uint32_t> parents;
+		std::vector<std::uint32_t> counts;
+		std::vector<std::uint8_t> hasDown;
+		std::vector<std::uint8_t> used;
+
+		void AssignSets();
+		void JoinRow(bool lastRow);
+		void CarveDown();
+		std::uint32_t FindSet(std::uint32_t set);
+		bool RandomBit();
+
+		GridPosition RandomStartPosition();
+		GridPosition RandomExitPosition();
+};
+
+#endif
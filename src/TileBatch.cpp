@@ -0,0 +1,241 @@
+#include "TileBatch.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <assert.h>
+
+void TileBatch::Build(const Matrix<TileType>& tiles, float tileSize, 
+		      TileColor color, TileColor wallColor, std::size_t maxChunks)
+{
+	this->tiles = &tiles;
+	this->tileSize = tileSize;
+	this->wallColor = wallColor;
+	this->maxChunks = std::max<std::size_t>(1, maxChunks);
+
+	chunksX = (tiles.GetWidth() + chunkTiles - 1) / chunkTiles;
+	chunksY = (tiles.GetHeight() + chunkTiles - 1) / chunkTiles;
+
+	palette.assign(1, color);
+	colorIndices.assign(static_cast<std::size_t>(tiles.GetWidth()) * tiles.GetHeight(), 0);
+
+	// The chunks keep their vertex buffers for the next grid.
+	usedSlots = 0;
+	chunkSlots.assign(static_cast<std::size_t>(chunksX) * chunksY, -1);
+	walls.Reserve(chunkTiles * chunkTiles);
+	frame = 0;
+	builtChunks = 0;
+}
+
+void TileBatch::SetColor(int x, int y, TileColor color)
+{
+	auto found = std::find(palette.begin(), palette.end(), color);
+
+	if (found == palette.end())
+	{
+		assert(palette.size() < 256);
+		found = palette.insert(palette.end(), color);
+	}
+
+	colorIndices[GetColorIndex(x, y)] = static_cast<std::uint8_t>(found - palette.begin());
+
+	int slot = chunkSlots[static_cast<std::size_t>(y / chunkTiles) * chunksX + x / chunkTiles];
+
+	if (slot < 0)
+		return;
+
+	TileChunk& chunk = slots[slot];
+	std::size_t first = GetVertexIndex(x, y);
+
+	for (std::size_t i = first; i < first + 4; i++) {
+		chunk.quads[i].color = color;
+	}
+
+	if (chunk.firstChanged == chunk.endChanged)
+	{
+		chunk.firstChanged = first;
+		chunk.endChanged = first + 4;
+	}
+	else
+	{
+		chunk.firstChanged = std::min(chunk.firstChanged, first);
+		chunk.endChanged = std::max(chunk.endChanged, first + 4);
+	}
+}
+
+void TileBatch::RebuildTile(int x, int y)
+{
+	std::size_t chunks[3] = {
+		static_cast<std::size_t>(y / chunkTiles) * chunksX + x / chunkTiles,
+		static_cast<std::size_t>(y / chunkTiles) * chunksX + std::max(0, x - 1) / chunkTiles,
+		static_cast<std::size_t>(std::max(0, y - 1) / chunkTiles) * chunksX + x / chunkTiles
+	};
+
+	for (int i = 0; i < 3; i++)
+	{
+		int slot = chunkSlots[chunks[i]];
+
+		if (slot < 0 || std::find(chunks, chunks + i, chunks[i]) != chunks + i)
+			continue;
+
+		BuildChunk(slots[slot]);
+	}
+}
+
+TileColor TileBatch::GetColor(int x, int y) const
+{
+	return palette[colorIndices[GetColorIndex(x, y)]];
+}
+
+void TileBatch::Draw(const ViewRect& view, TileBatchTarget& target)
+{
+	frame++;
+
+	float chunkSize = chunkTiles * tileSize;
+	int minX = std::max(0, static_cast<int>(std::floor(view.left / chunkSize)));
+	int minY = std::max(0, static_cast<int>(std::floor(view.top / chunkSize)));
+	int maxX = std::min(chunksX - 1, static_cast<int>(std::floor((view.left + view.width) / chunkSize)));
+	int maxY = std::min(chunksY - 1, static_cast<int>(std::floor((view.top + view.height) / chunkSize)));
+
+	for (int chunkY = minY; chunkY <= maxY; chunkY++)
+	{
+		for (int chunkX = minX; chunkX <= maxX; chunkX++)
+		{
+			int slot = AcquireSlot(chunkX, chunkY);
+			TileChunk& chunk = slots[slot];
+
+			target.DrawChunk(slot, chunk);
+
+			chunk.rebuilt = false;
+			chunk.firstChanged = 0;
+			chunk.endChanged = 0;
+		}
+	}
+}
+
+int TileBatch::GetCachedChunkCount() const
+{
+	return static_cast<int>(usedSlots);
+}
+
+// Returns the slot of a chunk, building it if it is not cached. When
+// the cache is full, the least recently drawn chunk is evicted, unless
+// it was drawn in this very frame: then the cache grows to fit the view.
+int TileBatch::AcquireSlot(int chunkX, int chunkY)
+{
+	int& chunkSlot = chunkSlots[static_cast<std::size_t>(chunkY) * chunksX + chunkX];
+
+	if (chunkSlot >= 0)
+	{
+		slots[chunkSlot].lastUsed = frame;
+		return chunkSlot;
+	}
+
+	int slot = static_cast<int>(usedSlots);
+
+	if (usedSlots >= maxChunks)
+	{
+		auto oldest = std::min_element(slots.begin(), slots.begin() + usedSlots, 
+			[](const TileChunk& a, const TileChunk& b) { return a.lastUsed < b.lastUsed; });
+
+		if (oldest->lastUsed != frame)
+		{
+			slot = static_cast<int>(oldest - slots.begin());
+			chunkSlots[static_cast<std::size_t>(oldest->chunkY) * chunksX + oldest->chunkX] = -1;
+		}
+	}
+
+	if (slot == static_cast<int>(usedSlots))
+	{
+		if (usedSlots == slots.size()) {
+			slots.emplace_back();
+		}
+
+		usedSlots++;
+	}
+
+	TileChunk& chunk = slots[slot];
+	chunk.chunkX = chunkX;
+	chunk.chunkY = chunkY;
+	chunk.lastUsed = frame;
+	BuildChunk(chunk);
+
+	chunkSlot = slot;
+	return slot;
+}
+
+// Quads are stored column by column, like the grid. Tiles were drawn
+// as rectangles with a one pixel outline of the same color, so the
+// quads are grown by a pixel on each side to look the same.
+void TileBatch::BuildChunk(TileChunk& chunk)
+{
+	MAZE_PROFILE_SCOPE("BuildChunk");
+	MAZE_PROFILE_COUNT("ChunksBuilt", 1);
+
+	int minX = chunk.chunkX * chunkTiles;
+	int minY = chunk.chunkY * chunkTiles;
+	int endX = std::min(tiles->GetWidth(), minX + chunkTiles);
+	int endY = std::min(tiles->GetHeight(), minY + chunkTiles);
+	const float margin = 1.0f;
+
+	// Slots are reused for any chunk, so each has room for a whole one.
+	const std::size_t maxVertices = chunkTiles * chunkTiles * 4;
+	chunk.quads.reserve(maxVertices);
+	chunk.quads.resize(static_cast<std::size_t>(endX - minX) * (endY - minY) * 4);
+	TileVertex* vertex = chunk.quads.data();
+
+	for (int x = minX; x < endX; x++)
+	{
+		float left = x * tileSize - margin;
+		float right = x * tileSize + tileSize + margin;
+		const std::uint8_t* colors = &colorIndices[GetColorIndex(x, 0)];
+
+		for (int y = minY; y < endY; y++)
+		{
+			float top = y * tileSize - margin;
+			float bottom = y * tileSize + tileSize + margin;
+			TileColor color = palette[colors[y]];
+
+			*vertex++ = { left, top, color };
+			*vertex++ = { right, top, color };
+			*vertex++ = { right, bottom, color };
+			*vertex++ = { left, bottom, color };
+		}
+	}
+
+	walls.Build(*tiles, minX, minY, endX, endY);
+	chunk.lines.clear();
+
+	// Every tile starts at most two segments, one to the right and one
+	// down, so the lines never need more vertices than the quads.
+	chunk.lines.reserve(maxVertices);
+
+	auto center = [&](GridPosition position) -> TileVertex
+	{
+		return { position.x * tileSize + tileSize * 0.5f, 
+			 position.y * tileSize + tileSize * 0.5f, wallColor };
+	};
+
+	for (const WallSegment& segment : walls.GetSegments())
+	{
+		chunk.lines.push_back(center(segment.from));
+		chunk.lines.push_back(center(segment.to));
+	}
+
+	chunk.rebuilt = true;
+	chunk.firstChanged = 0;
+	chunk.endChanged = 0;
+	builtChunks++;
+}
+
+// Colors are stored column by column, like the grid.
+std::size_t TileBatch::GetColorIndex(int x, int y) const
+{
+	return static_cast<std::size_t>(x) * tiles->GetHeight() + y;
+}
+
+// The last row of chunks may be shorter than the others.
+std::size_t TileBatch::GetVertexIndex(int x, int y) const
+{
+	int rows = std::min(chunkTiles, tiles->GetHeight() - (y / chunkTiles) * chunkTiles);
+	return (static_cast<std::size_t>(x % chunkTiles) * rows + y % chunkTiles) * 4;
+}
@@ -0,0 +1,133 @@
+#ifndef TILE_BATCH_H
+#define TILE_BATCH_H
+
+#include "Matrix.h"
+#include "Grid.h"
+#include "WallGeometry.h"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+struct TileColor
+{
+	std::uint8_t r {0};
+	std::uint8_t g {0};
+	std::uint8_t b {0};
+	std::uint8_t a {255};
+
+	bool operator==(const TileColor& other) const
+	{
+		return r == other.r && g == other.g && b == other.b && a == other.a;
+	}
+
+	bool operator!=(const TileColor& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+struct TileVertex
+{
+	float x {0.0f};
+	float y {0.0f};
+	TileColor color;
+};
+
+// The visible area, in pixels.
+struct ViewRect
+{
+	float left {0.0f};
+	float top {0.0f};
+	float width {0.0f};
+	float height {0.0f};
+};
+
+// The geometry of a square chunk of tiles: a quad per tile and
+// the wall lines leaving the chunk to the right or down.
+struct TileChunk
+{
+	int chunkX {-1};
+	int chunkY {-1};
+	std::vector<TileVertex> quads;
+	std::vector<TileVertex> lines;
+
+	// Set when the geometry was (re)built since the chunk was last drawn.
+	bool rebuilt {false};
+	// The quad vertices changed since the chunk was last drawn.
+	std::size_t firstChanged {0};
+	std::size_t endChanged {0};
+
+	std::uint64_t lastUsed {0};
+};
+
+// Receives the chunks of a TileBatch when it is drawn. The SFML view
+// uploads and draws them; anything else may simply record them.
+class TileBatchTarget
+{
+	public:
+		virtual ~TileBatchTarget() { }
+
+		// Called once per visible chunk. The slot identifies where the
+		// chunk is cached; a slot is reused when a chunk is evicted.
+		virtual void DrawChunk(int slot, const TileChunk& chunk) = 0;
+};
+
+// Draws the tiles and walls of a grid in square chunks. The geometry of
+// a chunk is built the first time the chunk is visible and is kept in 
+// a cache of limited size, where the least recently drawn chunk makes
+// room for a new one. Only the chunks within the view are drawn, so
+// the cost of a frame depends on the size of the view, not of the grid.
+class TileBatch
+{
+	public:
+		// Tiles per side of a chunk.
+		static constexpr int chunkTiles = 32;
+
+		// The tiles must outlive the batch; they are read whenever a chunk is built.
+		// Building again, e.g. for the next level, reuses the memory of the chunks.
+		void Build(const Matrix<TileType>& tiles, float tileSize, 
+			   TileColor color, TileColor wallColor, std::size_t maxChunks);
+
+		// Updates the color of a single tile, and its vertices if the chunk is cached.
+		void SetColor(int x, int y, TileColor color);
+		TileColor GetColor(int x, int y) const;
+
+		// Rebuilds the cached geometry around a tile whose type changed.
+		// Walls leaving the tiles to the left and above belong to their
+		// chunks, so those are rebuilt as well.
+		void RebuildTile(int x, int y);
+
+		// Builds the chunks within the view if needed and passes them to the target.
+		void Draw(const ViewRect& view, TileBatchTarget& target);
+
+		int GetCachedChunkCount() const;
+		std::uint64_t GetBuiltChunkCount() const { return builtChunks; }
+
+	private:
+		const Matrix<TileType>* tiles {nullptr};
+		float tileSize {0.0f};
+		TileColor wallColor;
+		std::size_t maxChunks {0};
+		int chunksX {0};
+		int chunksY {0};
+
+		// Tile colors are kept as indices into a small palette.
+		std::vector<TileColor> palette;
+		std::vector<std::uint8_t> colorIndices;
+
+		// Only the first usedSlots slots hold chunks of the current grid.
+		std::vector<TileChunk> slots;
+		std::size_t usedSlots {0};
+		// The slot of every chunk of the grid, or -1 if it is not cached.
+		std::vector<int> chunkSlots;
+		WallGeometry walls;
+		std::uint64_t frame {0};
+		std::uint64_t builtChunks {0};
+
+		int AcquireSlot(int chunkX, int chunkY);
+		void BuildChunk(TileChunk& chunk);
+		std::size_t GetColorIndex(int x, int y) const;
+		std::size_t GetVertexIndex(int x, int y) const;
+};
+
+#endif
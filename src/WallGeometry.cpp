@@ -0,0 +1,73 @@
+#include "WallGeometry.h"
+#include "Profiler.h"
+#include <algorithm>
+
+void WallGeometry::Build(const Matrix<TileType>& tiles)
+{
+	Build(tiles, 0, 0, tiles.GetWidth(), tiles.GetHeight());
+}
+
+// The grid is stored column by column, so it is scanned the same way.
+// Vertical runs end within the column; horizontal runs are tracked
+// across columns with the start of the run on each row. The column
+// and row past the area are read, but only to finish runs leaving it.
+void WallGeometry::Build(const Matrix<TileType>& tiles, int minX, int minY, int endX, int endY)
+{
+	MAZE_PROFILE_SCOPE("BuildWalls");
+
+	int lastX = std::min(endX, tiles.GetWidth() - 1);
+	int lastY = std::min(endY, tiles.GetHeight() - 1);
+
+	segments.clear();
+	runStarts.assign(endY - minY, -1);
+
+	for (int x = minX; x <= lastX + 1; x++)
+	{
+		int columnStart = -1;
+		bool ownColumn = x < endX;
+
+		for (int y = minY; y <= lastY + 1; y++)
+		{
+			bool wall = x <= lastX && y <= lastY && tiles[x][y] == TileType::Wall;
+			bool ownRow = y < endY;
+			int* runStart = ownRow ? &runStarts[y - minY] : nullptr;
+
+			if (wall)
+			{
+				if (ownColumn && columnStart < 0) {
+					columnStart = y;
+				}
+
+				if (ownRow && *runStart < 0) {
+					*runStart = x;
+				}
+
+				continue;
+			}
+
+			if (columnStart >= 0 && y - 1 > columnStart) {
+				segments.push_back({ { x, columnStart }, { x, y - 1 } });
+			}
+
+			if (ownRow && *runStart >= 0 && x - 1 > *runStart) {
+				segments.push_back({ { *runStart, y }, { x - 1, y } });
+			}
+
+			columnStart = -1;
+
+			if (ownRow) {
+				*runStart = -1;
+			}
+		}
+	}
+}
+
+const std::vector<WallSegment>& WallGeometry::GetSegments() const
+{
+	return segments;
+}
+
+std::size_t WallGeometry::GetVertexCount() const
+{
+	return segments.size() * 2;
+}
@@ -0,0 +1,45 @@
+#ifndef WALL_GEOMETRY_H
+#define WALL_GEOMETRY_H
+
+#include "Matrix.h"
+#include "Grid.h"
+#include <vector>
+#include <cstdint>
+
+// A straight wall between the centers of two wall tiles,
+// in tile coordinates. Either x or y is the same at both ends.
+struct WallSegment
+{
+	GridPosition from;
+	GridPosition to;
+};
+
+// Builds the lines drawn for the walls of a maze. A line joins the
+// centers of adjacent wall tiles; straight runs of walls are merged
+// into a single segment and every segment is emitted exactly once.
+class WallGeometry
+{
+	public:
+		void Build(const Matrix<TileType>& tiles);
+
+		// Builds only the walls leaving the tiles in [minX, endX) x [minY, endY)
+		// to the right or down. Building adjacent areas this way covers
+		// every wall once; runs are cut at the edges of the area.
+		void Build(const Matrix<TileType>& tiles, int minX, int minY, int endX, int endY);
+
+		const std::vector<WallSegment>& GetSegments() const;
+
+		// Makes room for areas of up to this many tiles, so that building
+		// them never allocates. At most two segments start at a tile.
+		void Reserve(std::size_t tileCount) { segments.reserve(tileCount * 2); }
+
+		// The number of vertices needed to draw the segments as lines.
+		std::size_t GetVertexCount() const;
+
+	private:
+		std::vector<WallSegment> segments;
+		// Start of the horizontal run in progress on each row, or -1.
+		std::vector<int> runStarts;
+};
+
+#endif
@@ -0,0 +1,149 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+{
+	if (threadCount <= 0) {
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	for (int i = 0; i < threadCount; i++) {
+		workers.push_back(std::make_unique<Worker>());
+	}
+
+	for (int i = 0; i < threadCount; i++) {
+		threads.emplace_back(&WorkStealingPool::Run, this, i);
+	}
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+
+	wakeUp.notify_all();
+
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+void WorkStealingPool::Submit(Task task)
+{
+	Worker& worker = *workers[nextWorker++ % workers.size()];
+
+	// The counters go up before the task is queued, so a worker that
+	// takes and finishes it at once never takes them below zero.
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		queuedTasks++;
+		pendingTasks++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.tasks.push_back(std::move(task));
+	}
+
+	wakeUp.notify_one();
+}
+
+void WorkStealingPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(sleepMutex);
+	allDone.wait(lock, [this] { return pendingTasks == 0; });
+}
+
+WorkerStats WorkStealingPool::GetWorkerStats(int worker) const
+{
+	WorkerStats stats;
+	stats.tasksRun = workers[worker]->tasksRun;
+	stats.tasksStolen = workers[worker]->tasksStolen;
+	stats.busyNanoseconds = workers[worker]->busyNanoseconds;
+	return stats;
+}
+
+void WorkStealingPool::Run(int worker)
+{
+	using namespace std::chrono;
+
+	while (true)
+	{
+		Task task;
+		bool stolen = false;
+
+		if (!TakeTask(worker, task, stolen))
+		{
+			std::unique_lock<std::mutex> lock(sleepMutex);
+
+			if (stopping)
+				return;
+
+			// Sleep until a task is queued. Another worker may take it
+			// first, in which case the deques are simply checked again.
+			wakeUp.wait(lock, [this] { return stopping || queuedTasks > 0; });
+
+			if (stopping)
+				return;
+
+			continue;
+		}
+
+		auto begin = steady_clock::now();
+		task(worker);
+		auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - begin).count();
+
+		Worker& self = *workers[worker];
+		self.busyNanoseconds += elapsed;
+		self.tasksRun++;
+
+		if (stolen) {
+			self.tasksStolen++;
+		}
+
+		std::lock_guard<std::mutex> lock(sleepMutex);
+
+		if (--pendingTasks == 0) {
+			allDone.notify_all();
+		}
+	}
+}
+
+// Takes a task from the back of the worker's own deque, or steals
+// one from the front of another worker's deque.
+bool WorkStealingPool::TakeTask(int worker, Task& outTask, bool& outStolen)
+{
+	{
+		Worker& self = *workers[worker];
+		std::lock_guard<std::mutex> lock(self.mutex);
+
+		if (!self.tasks.empty())
+		{
+			outTask = std::move(self.tasks.back());
+			self.tasks.pop_back();
+			queuedTasks--;
+			outStolen = false;
+			return true;
+		}
+	}
+
+	for (std::size_t i = 1; i < workers.size(); i++)
+	{
+		Worker& victim = *workers[(worker + i) % workers.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+
+		if (!victim.tasks.empty())
+		{
+			outTask = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			queuedTasks--;
+			outStolen = true;
+			return true;
+		}
+	}
+
+	return false;
+}
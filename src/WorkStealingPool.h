@@ -0,0 +1,73 @@
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Per-worker counters of a WorkStealingPool.
+struct WorkerStats
+{
+	std::uint64_t tasksRun {0};
+	std::uint64_t tasksStolen {0};
+	std::uint64_t busyNanoseconds {0};
+};
+
+// A pool of threads where every worker has its own deque of tasks.
+// A worker takes tasks from the back of its own deque and, once that
+// is empty, steals from the front of the other workers' deques, so
+// that uneven tasks still keep every thread busy. Tasks receive the
+// index of the worker running them, which lets callers keep per-worker
+// state without any locking.
+class WorkStealingPool
+{
+	public:
+		typedef std::function<void(int worker)> Task;
+
+		explicit WorkStealingPool(int threadCount = 0);
+		~WorkStealingPool();
+
+		WorkStealingPool(const WorkStealingPool&) = delete;
+		WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+		// Tasks are spread over the workers in turn.
+		void Submit(Task task);
+
+		// Blocks until every submitted task has finished.
+		void Wait();
+
+		int GetThreadCount() const { return static_cast<int>(workers.size()); }
+		WorkerStats GetWorkerStats(int worker) const;
+
+	private:
+		struct Worker
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+			std::atomic<std::uint64_t> tasksRun {0};
+			std::atomic<std::uint64_t> tasksStolen {0};
+			std::atomic<std::uint64_t> busyNanoseconds {0};
+		};
+
+		std::vector<std::unique_ptr<Worker>> workers;
+		std::vector<std::thread> threads;
+		std::atomic<std::size_t> nextWorker {0};
+		std::atomic<std::size_t> queuedTasks {0};
+		std::atomic<std::size_t> pendingTasks {0};
+		bool stopping {false};
+
+		std::mutex sleepMutex;
+		std::condition_variable wakeUp;
+		std::condition_variable allDone;
+
+		void Run(int worker);
+		bool TakeTask(int worker, Task& outTask, bool& outStolen);
+};
+
+#endif
@@ -0,0 +1,107 @@
+// Measures how fast crowds of agents walk to the exit of a maze.
+//
+// Usage: AgentBenchmark [--size 2001] [--agents 1000,10000,100000,1000000]
+//                       [--ticks 200] [--threads N]
+//
+// For each crowd size, agents are spawned on random open cells of the
+// same maze and ticked a fixed number of times, serially and on a pool
+// of threads. Agents at the exit keep being ticked, so every tick
+// costs the same. Reports agent-steps per second, where an agent-step
+// is one lookup in the distance field.
+#include "MazeGenerator.h"
+#include "AgentSimulation.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static std::vector<std::uint64_t> ParseList(const char* text)
+{
+	std::vector<std::uint64_t> values;
+
+	while (*text)
+	{
+		char* end;
+		values.push_back(std::strtoull(text, &end, 10));
+		text = (*end == ',') ? end + 1 : end;
+
+		if (end == text && *end != '\0')
+			break;
+	}
+
+	return values;
+}
+
+static double Measure(AgentSimulation& simulation, int ticks, WorkStealingPool* pool)
+{
+	auto begin = std::chrono::steady_clock::now();
+
+	for (int tick = 0; tick < ticks; tick++) {
+		simulation.Tick(pool);
+	}
+
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main(int argc, char** argv)
+{
+	int size = 2001;
+	std::vector<std::uint64_t> agentCounts = { 1000, 10000, 100000, 1000000 };
+	int ticks = 200;
+	int threadCount = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+
+		if (std::strcmp(argv[i], "--size") == 0 && hasValue) {
+			size = std::atoi(argv[++i]) | 1;
+		}
+		else if (std::strcmp(argv[i], "--agents") == 0 && hasValue) {
+			agentCounts = ParseList(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--ticks") == 0 && hasValue) {
+			ticks = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+			threadCount = std::atoi(argv[++i]);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: %s [--size N] [--agents 1000,10000] [--ticks N] [--threads N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	MazeGenerator generator;
+	std::unique_ptr<Maze> maze = generator.Create(size, size, 42);
+
+	DistanceField field;
+	auto begin = std::chrono::steady_clock::now();
+	field.Build(*maze);
+	double fieldSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	std::printf("maze %dx%d, distance field built in %.2f ms (%.2f ns/cell)\n", size, size,
+	            fieldSeconds * 1e3, fieldSeconds * 1e9 / field.GetCellCount());
+
+	WorkStealingPool pool(threadCount);
+	std::printf("%10s %22s %22s (%d threads)\n", "agents", "serial steps/s", "pool steps/s", pool.GetThreadCount());
+
+	for (std::uint64_t agentCount : agentCounts)
+	{
+		RandomEngine random(7);
+		AgentSimulation simulation;
+		simulation.Reset(field);
+		simulation.Spawn(*maze, agentCount, random);
+
+		double steps = static_cast<double>(agentCount) * ticks * AgentSimulation::maxSpeed;
+		double serialSeconds = Measure(simulation, ticks, nullptr);
+		double poolSeconds = Measure(simulation, ticks, &pool);
+
+		std::printf("%10llu %22.3e %22.3e\n", static_cast<unsigned long long>(agentCount), 
+		            steps / serialSeconds, steps / poolSeconds);
+	}
+
+	return 0;
+}
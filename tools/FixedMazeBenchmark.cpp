@@ -0,0 +1,136 @@
+// Compares mazes of a size fixed at compile time with the ones sized at
+// run time, for the small sizes used by fixed levels.
+//
+// Usage: FixedMazeBenchmark [--iterations 20000]
+//
+// For each size, reports the time per maze to generate with
+// MazeGenerator, to generate with FixedMazeGenerator at run time and to
+// copy a level baked in at compile time, and the time per cell of a
+// pass that reads the four neighbours of every cell through Matrix and
+// through FixedMatrix. Every generated maze is checked to match the
+// one from MazeGenerator.
+#include "MazeGenerator.h"
+#include "FixedMazeGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const std::uint64_t bakedSeed = 42;
+
+// Dead ends are open cells with three walls around them. Counting them
+// reads the four neighbours of every inner cell.
+template <class Tiles>
+static int CountDeadEnds(const Tiles& tiles, int width, int height)
+{
+	int count = 0;
+
+	for (int x = 1; x < width - 1; x++)
+	{
+		for (int y = 1; y < height - 1; y++)
+		{
+			int walls = (tiles(x - 1, y) == TileType::Wall) + (tiles(x + 1, y) == TileType::Wall) +
+			            (tiles(x, y - 1) == TileType::Wall) + (tiles(x, y + 1) == TileType::Wall);
+			count += (tiles(x, y) != TileType::Wall && walls == 3);
+		}
+	}
+
+	return count;
+}
+
+template <class Function>
+static double MeasureNanoseconds(int iterations, Function function)
+{
+	auto begin = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < iterations; i++) {
+		function(i);
+	}
+
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / iterations;
+}
+
+template <int Size>
+static bool Run(int iterations)
+{
+	static constexpr FixedMaze<Size, Size> baked = FixedMazeGenerator<Size, Size>::Create(bakedSeed);
+
+	MazeGenerator generator;
+	std::unique_ptr<Maze> maze;
+	FixedMaze<Size, Size> fixedMaze;
+	bool same = true;
+	// Keeps the results alive, so that no loop is optimized away.
+	volatile int sink = 0;
+
+	double dynamicTime = MeasureNanoseconds(iterations, [&](int i)
+	{
+		maze = generator.Create(Size, Size, i);
+	});
+
+	double fixedTime = MeasureNanoseconds(iterations, [&](int i)
+	{
+		fixedMaze = FixedMazeGenerator<Size, Size>::Create(i);
+		sink = sink + fixedMaze.startPosition.x;
+	});
+
+	double bakedTime = MeasureNanoseconds(iterations, [&](int)
+	{
+		fixedMaze = baked;
+		sink = sink + fixedMaze.startPosition.x;
+	});
+
+	for (std::uint64_t seed : { bakedSeed, std::uint64_t(1), std::uint64_t(iterations - 1) })
+	{
+		maze = generator.Create(Size, Size, seed);
+		fixedMaze = FixedMazeGenerator<Size, Size>::Create(seed);
+
+		same = same && fixedMaze.tiles.ToMatrix().cells == maze->GetTiles().cells &&
+		       fixedMaze.startPosition.x == maze->GetStartPosition().x &&
+		       fixedMaze.startPosition.y == maze->GetStartPosition().y &&
+		       fixedMaze.exitPosition.x == maze->GetExitPosition().x &&
+		       fixedMaze.exitPosition.y == maze->GetExitPosition().y;
+	}
+
+	same = same && baked.tiles.cells == FixedMazeGenerator<Size, Size>::Create(bakedSeed).tiles.cells;
+
+	const Matrix<TileType>& tiles = maze->GetTiles();
+	double cells = static_cast<double>(Size) * Size;
+
+	double dynamicScan = MeasureNanoseconds(iterations, [&](int)
+	{
+		sink = sink + CountDeadEnds(tiles, tiles.GetWidth(), tiles.GetHeight());
+	}) / cells;
+
+	double fixedScan = MeasureNanoseconds(iterations, [&](int)
+	{
+		sink = sink + CountDeadEnds(fixedMaze.tiles, Size, Size);
+	}) / cells;
+
+	std::printf("%5d %14.0f %14.0f %14.1f %12.3f %12.3f %6s\n", Size, dynamicTime, fixedTime, bakedTime,
+	            dynamicScan, fixedScan, same ? "yes" : "NO");
+	return same;
+}
+
+int main(int argc, char** argv)
+{
+	int iterations = 20000;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+			iterations = std::max(3, std::atoi(argv[++i]));
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: %s [--iterations N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	std::printf("%5s %14s %14s %14s %12s %12s %6s\n", "size", "dynamic ns", "fixed ns", "baked ns",
+	            "dynamic ns/c", "fixed ns/c", "same");
+
+	bool same = Run<11>(iterations) & Run<21>(iterations) & Run<51>(iterations) & Run<101>(iterations);
+	return same ? 0 : 1;
+}
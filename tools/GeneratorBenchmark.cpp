@@ -0,0 +1,136 @@
+// Compares the throughput of the carving algorithms on large mazes.
+//
+// Usage: GeneratorBenchmark [--sizes 4001,8001,16001,32001] [--threads N]
+//                           [--repeat 2]
+//
+// Every algorithm generates a maze of each size into the same Maze
+// several times; the fastest run is reported in milliseconds and in
+// cells (tiles of the grid) per second. The column carvers run once
+// serially and once on a pool of threads. The last maze of every run
+// is checked to be perfect with MazeValidator on the pool, whose speed
+// is reported in GB/s of grid.
+#include "MazeGenerator.h"
+#include "ColumnCarver.h"
+#include "MazeValidator.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static std::vector<int> ParseSizes(const char* text)
+{
+	std::vector<int> sizes;
+
+	while (*text)
+	{
+		char* end;
+		sizes.push_back(static_cast<int>(std::strtol(text, &end, 10)));
+		text = (*end == ',') ? end + 1 : end;
+
+		if (end == text && *end != '\0')
+			break;
+	}
+
+	return sizes;
+}
+
+template <class Carver>
+static std::unique_ptr<MazeCarver> CreateCarver(WorkStealingPool* pool)
+{
+	return std::make_unique<Carver>(pool);
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<int> sizes = { 4001, 8001, 16001, 32001 };
+	int threadCount = 0;
+	int repeat = 2;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+
+		if (std::strcmp(argv[i], "--sizes") == 0 && hasValue) {
+			sizes = ParseSizes(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+			threadCount = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--repeat") == 0 && hasValue) {
+			repeat = std::max(1, std::atoi(argv[++i]));
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: %s [--sizes 4001,8001] [--threads N] [--repeat N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	WorkStealingPool pool(threadCount);
+
+	struct Algorithm
+	{
+		const char* name;
+		// Creates the carver; without one, the generator searches depth first.
+		std::unique_ptr<MazeCarver> (*createCarver)(WorkStealingPool* pool);
+		bool usesPool;
+	};
+
+	const Algorithm algorithms[] =
+	{
+		{ "depth-first", nullptr, false },
+		{ "binary-tree", CreateCarver<BinaryTreeCarver>, false },
+		{ "binary-tree", CreateCarver<BinaryTreeCarver>, true },
+		{ "sidewinder", CreateCarver<SidewinderCarver>, false },
+		{ "sidewinder", CreateCarver<SidewinderCarver>, true },
+	};
+
+	std::printf("%6s %-12s %8s %12s %14s %13s %8s\n", "size", "algorithm", "threads", "ms/maze", "cells/s",
+	            "validate GB/s", "perfect");
+
+	Maze maze {Matrix<TileType>(), {}, {}, 0};
+	MazeValidator validator;
+	bool allPerfect = true;
+
+	for (int size : sizes)
+	{
+		for (const Algorithm& algorithm : algorithms)
+		{
+			MazeGenerator generator;
+
+			if (algorithm.createCarver != nullptr) {
+				generator.SetCarver(algorithm.createCarver(algorithm.usesPool ? &pool : nullptr));
+			}
+
+			double best = 0.0;
+
+			for (int run = 0; run < repeat; run++)
+			{
+				auto begin = std::chrono::steady_clock::now();
+				generator.Create(size, size, 42 + run, maze);
+				double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+				best = (run == 0) ? seconds : std::min(best, seconds);
+			}
+
+			auto begin = std::chrono::steady_clock::now();
+			const ValidationReport& report = validator.Validate(maze, &pool);
+			double validateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			allPerfect = allPerfect && report.IsValid();
+
+			std::printf("%6d %-12s %8d %12.1f %14.3e %13.2f %8s\n", size, algorithm.name,
+			            algorithm.usesPool ? pool.GetThreadCount() : 1, best * 1000.0,
+			            static_cast<double>(size) * size / best, report.bytes / validateSeconds * 1e-9,
+			            report.IsValid() ? "yes" : "NO");
+
+			for (const MazeViolation& violation : report.violations) {
+				std::printf("       %s at %d, %d\n", GetRuleName(violation.rule), violation.position.x, violation.position.y);
+			}
+		}
+	}
+
+	return allPerfect ? 0 : 1;
+}
@@ -0,0 +1,346 @@
+// Generates a corpus of mazes without a window.
+//
+// Usage: MazeBatch --seeds FIRST:COUNT --sizes 21,51,101 [--threads N]
+//                  [--no-solve] [--validate] [--output FILE]
+//                  [--images DIR] [--pixels N] [--format png|ppm|bin]
+//
+// Each maze is written as a header line followed by its rows, where
+// '#' is a wall, 'E' is the exit and '.' is on the solution path.
+// With --images, every maze is also drawn to DIR/maze-SIZE-SEED.png,
+// with N pixels per cell (2 by default). With --format bin, every maze
+// is instead written to DIR/maze-SIZE-SEED.maze in the MazeFile format,
+// which MappedMaze can load and replay. With --validate, every maze is
+// checked to be perfect and the violations of invalid mazes are listed.
+// Statistics are printed to stderr; the exit code is 1 if any maze is
+// invalid.
+//
+// With --stream, every maze is instead made by the streaming generator,
+// SIZE wide and --height tiles tall (as tall as it is wide by default),
+// and its rows are written to FILE, or stdout, as they are generated:
+// a line "stream SEED WIDTH HEIGHT", the rows, and a line
+// "start X Y exit X Y". Only the row being generated is kept, unless
+// --validate collects the rows to check the maze. The rows per second
+// are printed to stderr.
+#include "BatchGenerator.h"
+#include "MazeFile.h"
+#include "MazeRasterizer.h"
+#include "MazeValidator.h"
+#include "StreamingMazeGenerator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static std::vector<int> ParseSizes(const char* text)
+{
+	std::vector<int> sizes;
+
+	while (*text)
+	{
+		char* end;
+		sizes.push_back(static_cast<int>(std::strtol(text, &end, 10)));
+		text = (*end == ',') ? end + 1 : end;
+
+		if (end == text && *end != '\0')
+			break;
+	}
+
+	return sizes;
+}
+
+// Streams a maze of every size for every seed to the file.
+static int RunStream(const BatchSettings& settings, int height, std::FILE* file)
+{
+	StreamingMazeGenerator generator;
+	MazeValidator validator;
+	Matrix<TileType> tiles;
+	std::vector<char> line;
+	std::uint64_t rowCount = 0;
+	std::uint64_t nanoseconds = 0;
+	std::uint64_t invalidCount = 0;
+	bool writeFailed = false;
+
+	for (std::uint64_t seed = settings.firstSeed; seed < settings.firstSeed + settings.seedCount; seed++)
+	{
+		for (int width : settings.sizes)
+		{
+			int mazeHeight = (height > 0) ? height : width;
+			line.resize(static_cast<std::size_t>(width) + 1);
+			line[width] = '\n';
+
+			if (settings.validate) {
+				tiles.Reset(width, mazeHeight, TileType::Wall);
+			}
+
+			std::fprintf(file, "stream %llu %d %d\n", static_cast<unsigned long long>(seed), width, mazeHeight);
+
+			StreamedMaze maze = generator.Generate(width, mazeHeight, seed, [&](int y, const TileType* row, int rowWidth)
+			{
+				for (int x = 0; x < rowWidth; x++)
+				{
+					line[x] = (row[x] == TileType::Wall) ? '#' : (row[x] == TileType::Exit) ? 'E' : ' ';
+
+					if (settings.validate) {
+						tiles(x, y) = row[x];
+					}
+				}
+
+				if (std::fwrite(line.data(), 1, line.size(), file) != line.size()) {
+					writeFailed = true;
+				}
+			});
+
+			std::fprintf(file, "start %d %d exit %d %d\n", maze.startPosition.x, maze.startPosition.y,
+			             maze.exitPosition.x, maze.exitPosition.y);
+
+			rowCount += maze.height;
+			nanoseconds += maze.nanoseconds;
+
+			if (!settings.validate)
+				continue;
+
+			// The grid goes back into tiles for the next maze.
+			Maze streamed(std::move(tiles), maze.startPosition, maze.exitPosition, seed);
+			const ValidationReport& report = validator.Validate(streamed);
+			tiles = streamed.ReleaseTiles();
+
+			if (!report.IsValid())
+			{
+				std::fprintf(stderr, "streamed maze %d seed %llu is not perfect\n", width,
+				             static_cast<unsigned long long>(seed));
+
+				for (const MazeViolation& violation : report.violations) {
+					std::fprintf(stderr, "  %s at %d, %d\n", GetRuleName(violation.rule), violation.position.x, violation.position.y);
+				}
+
+				invalidCount++;
+			}
+		}
+	}
+
+	if (std::fflush(file) != 0 || writeFailed)
+	{
+		std::fprintf(stderr, "Cannot write the streamed rows\n");
+		return 1;
+	}
+
+	std::fprintf(stderr, "%llu rows in %.3f s: %.0f rows/s\n", static_cast<unsigned long long>(rowCount),
+	             nanoseconds * 1e-9, nanoseconds > 0 ? rowCount * 1e9 / nanoseconds : 0.0);
+
+	if (settings.validate)
+	{
+		std::fprintf(stderr, "%llu of %llu streamed mazes invalid\n", static_cast<unsigned long long>(invalidCount),
+		             static_cast<unsigned long long>(settings.seedCount * settings.sizes.size()));
+	}
+
+	return invalidCount > 0 ? 1 : 0;
+}
+
+int main(int argc, char** argv)
+{
+	BatchSettings settings;
+	const char* output = nullptr;
+	const char* imageDirectory = nullptr;
+	const char* imageFormat = "png";
+	RasterSettings rasterSettings;
+	rasterSettings.pixelsPerCell = 2;
+	bool stream = false;
+	int streamHeight = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+
+		if (std::strcmp(argv[i], "--seeds") == 0 && hasValue)
+		{
+			char* end;
+			settings.firstSeed = std::strtoull(argv[++i], &end, 10);
+			settings.seedCount = (*end == ':') ? std::strtoull(end + 1, nullptr, 10) : 1;
+		}
+		else if (std::strcmp(argv[i], "--sizes") == 0 && hasValue) {
+			settings.sizes = ParseSizes(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+			settings.threadCount = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--output") == 0 && hasValue) {
+			output = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--images") == 0 && hasValue) {
+			imageDirectory = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--pixels") == 0 && hasValue) {
+			rasterSettings.pixelsPerCell = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--format") == 0 && hasValue) {
+			imageFormat = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--no-solve") == 0) {
+			settings.solve = false;
+		}
+		else if (std::strcmp(argv[i], "--validate") == 0) {
+			settings.validate = true;
+		}
+		else if (std::strcmp(argv[i], "--stream") == 0) {
+			stream = true;
+		}
+		else if (std::strcmp(argv[i], "--height") == 0 && hasValue) {
+			streamHeight = std::atoi(argv[++i]);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: %s --seeds FIRST:COUNT --sizes 21,51,101 "
+			                     "[--threads N] [--no-solve] [--validate] [--output FILE] "
+			                     "[--images DIR] [--pixels N] [--format png|ppm|bin]\n"
+			                     "       %s --stream --seeds FIRST:COUNT --sizes 21,51,101 "
+			                     "[--height N] [--validate] [--output FILE]\n", argv[0], argv[0]);
+			return 1;
+		}
+	}
+
+	for (int size : settings.sizes)
+	{
+		if (size < 3 || size % 2 == 0)
+		{
+			std::fprintf(stderr, "Sizes must be odd and at least 3: %d\n", size);
+			return 1;
+		}
+	}
+
+	if (streamHeight != 0 && (streamHeight < 3 || streamHeight % 2 == 0))
+	{
+		std::fprintf(stderr, "The height must be odd and at least 3: %d\n", streamHeight);
+		return 1;
+	}
+
+	std::FILE* file = nullptr;
+
+	if (stream && output == nullptr) {
+		output = "-";
+	}
+
+	if (output != nullptr)
+	{
+		file = (std::strcmp(output, "-") == 0) ? stdout : std::fopen(output, "wb");
+
+		if (file == nullptr)
+		{
+			std::fprintf(stderr, "Cannot open %s\n", output);
+			return 1;
+		}
+	}
+
+	if (stream)
+	{
+		int result = RunStream(settings, streamHeight, file);
+
+		if (file != stdout) {
+			std::fclose(file);
+		}
+
+		return result;
+	}
+
+	bool binary = std::strcmp(imageFormat, "bin") == 0;
+
+	if (std::strcmp(imageFormat, "png") != 0 && std::strcmp(imageFormat, "ppm") != 0 && !binary)
+	{
+		std::fprintf(stderr, "Unknown image format: %s\n", imageFormat);
+		return 1;
+	}
+
+	std::vector<char> buffer;
+	BatchGenerator generator;
+	MazeRasterizer rasterizer;
+	PngEncoder pngEncoder;
+	PpmEncoder ppmEncoder;
+	ImageEncoder& encoder = (std::strcmp(imageFormat, "ppm") == 0) ? static_cast<ImageEncoder&>(ppmEncoder) : pngEncoder;
+	std::uint64_t imageCount = 0;
+	std::uint64_t imageBytes = 0;
+	std::uint64_t imageCells = 0;
+	double imageSeconds = 0.0;
+	bool imagesFailed = false;
+
+	BatchStats stats = generator.Run(settings, [&](BatchResult& result)
+	{
+		if (!result.valid)
+		{
+			std::fprintf(stderr, "maze %d seed %llu is not perfect\n", result.maze->GetWidth(),
+			             static_cast<unsigned long long>(result.maze->GetSeed()));
+
+			for (const MazeViolation& violation : result.violations) {
+				std::fprintf(stderr, "  %s at %d, %d\n", GetRuleName(violation.rule), violation.position.x, violation.position.y);
+			}
+		}
+
+		if (file != nullptr) {
+			MazeFile::WriteText(*result.maze, file, buffer);
+		}
+
+		if (imageDirectory != nullptr && !imagesFailed)
+		{
+			char path[1024];
+			std::snprintf(path, sizeof(path), "%s/maze-%d-%llu.%s", imageDirectory, result.maze->GetWidth(),
+			              static_cast<unsigned long long>(result.maze->GetSeed()), binary ? "maze" : imageFormat);
+
+			auto begin = std::chrono::steady_clock::now();
+			bool written;
+
+			if (binary) {
+				written = MazeFile::Write(*result.maze, path);
+			}
+			else
+			{
+				std::FILE* imageFile = std::fopen(path, "wb");
+				written = imageFile != nullptr && rasterizer.Write(*result.maze, rasterSettings, encoder, imageFile);
+
+				if (imageFile != nullptr && std::fclose(imageFile) != 0) {
+					written = false;
+				}
+			}
+
+			imageSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			if (!written)
+			{
+				std::fprintf(stderr, "Cannot write %s\n", path);
+				imagesFailed = true;
+				return;
+			}
+
+			imageCount++;
+			imageBytes += binary ? MazeFile::GetFileSize(*result.maze) : encoder.GetBytesWritten();
+			imageCells += static_cast<std::uint64_t>(result.maze->GetWidth()) * result.maze->GetHeight();
+		}
+	});
+
+	if (file != nullptr && file != stdout) {
+		std::fclose(file);
+	}
+
+	std::fprintf(stderr, "%llu mazes in %.3f s: %.1f mazes/s, p50 %.3f ms, p99 %.3f ms\n",
+	             static_cast<unsigned long long>(stats.mazeCount), stats.seconds, 
+	             stats.GetMazesPerSecond(), stats.medianNanoseconds * 1e-6, stats.p99Nanoseconds * 1e-6);
+
+	if (imageCount > 0)
+	{
+		std::fprintf(stderr, "%llu %s in %.3f s: %.1f files/s, %.1f MB/s, %.3f B/cell\n",
+		             static_cast<unsigned long long>(imageCount), binary ? "maze files" : "images", imageSeconds, 
+		             imageCount / imageSeconds, imageBytes / imageSeconds / 1e6,
+		             static_cast<double>(imageBytes) / imageCells);
+	}
+
+	if (settings.validate)
+	{
+		std::fprintf(stderr, "%llu of %llu mazes invalid, validated at %.2f GB/s per worker\n",
+		             static_cast<unsigned long long>(stats.invalidCount),
+		             static_cast<unsigned long long>(stats.mazeCount), stats.GetValidationBytesPerSecond() * 1e-9);
+	}
+
+	for (std::size_t worker = 0; worker < stats.utilization.size(); worker++) {
+		std::fprintf(stderr, "worker %zu: %.1f%% busy\n", worker, stats.utilization[worker] * 100.0);
+	}
+
+	return (imagesFailed || stats.invalidCount > 0) ? 1 : 0;
+}
@@ -0,0 +1,919 @@
+// Benchmarks the phases of the maze pipeline separately: generation,
+// wall geometry, tile geometry, every solver, the distance field,
+// the path index and PNG export.
+// The mutate phases open and close 64 walls of a solved maze, one at
+// a time, and repair the solution after every change: incrementally,
+// or with a full breadth-first search. Their time per cell is for the
+// whole sequence of 128 changes. The level-reuse phase generates,
+// solves and builds the visible tiles of a level into the buffers of
+// a previous one, and must not allocate at all. The file phase writes
+// the solved maze to MazeBenchmark.maze in the working directory and
+// maps it back; file-text does the same with the text dump of MazeBatch
+// in MazeBenchmark.txt. Both report the bytes per cell of their file
+// and check that the maze comes back unchanged, and the file phase
+// also checks that a flipped bit fails the checksum and that a start
+// outside the grid fails to open. With --threads, generate-parallel
+// runs once per thread count as generate-parallel-tN, and every maze
+// must be the same for all of them.
+//
+// Usage: MazeBenchmark [--sizes 21,101,1001,4001,16001] [--seeds 1,2,3]
+//                      [--phases generate,walls,...] [--output FILE]
+//                      [--compare BASELINE] [--threshold PERCENT]
+//                      [--threads 1,2,4,8,16,32]
+//
+// Every phase runs once per seed on each size and reports the median
+// time per cell, heap allocations per run, the peak resident set of
+// the process and, on Linux where perf events are allowed, cycles,
+// instructions and cache misses per cell. Results are written as JSON
+// to stdout or FILE. With --compare, every result is compared against
+// the same phase and size in a saved run, regressions beyond the
+// threshold (10% by default) are listed on stderr and the exit code is 2.
+// If a phase that must not allocate does, the exit code is 3, and if a
+// file does not survive its round trip or the threads change a maze,
+// the exit code is 4.
+#include "MazeGenerator.h"
+#include "MazeSolver.h"
+#include "WallGeometry.h"
+#include "TileBatch.h"
+#include "DistanceField.h"
+#include "IncrementalSolver.h"
+#include "PathIndex.h"
+#include "MazeRasterizer.h"
+#include "MazeFile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <new>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Every allocation of the process is counted, so that a phase can
+// report how many it made.
+static std::atomic<std::uint64_t> allocationCount(0);
+
+void* operator new(std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* memory = std::malloc(size ? size : 1))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+static std::uint64_t GetPeakRssKilobytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+	return counters.PeakWorkingSetSize / 1024;
+#else
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// Hardware counters for the calling thread. Opening them fails on
+// other platforms, in containers and when perf events are restricted,
+// in which case nothing is reported.
+class HardwareCounters
+{
+	public:
+		enum Counter { Cycles, Instructions, CacheMisses, CounterCount };
+
+		HardwareCounters()
+		{
+#ifdef __linux__
+			const std::uint64_t configs[CounterCount] = {
+				PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES
+			};
+
+			for (int i = 0; i < CounterCount; i++)
+			{
+				perf_event_attr attributes;
+				std::memset(&attributes, 0, sizeof(attributes));
+				attributes.type = PERF_TYPE_HARDWARE;
+				attributes.size = sizeof(attributes);
+				attributes.config = configs[i];
+				attributes.disabled = 1;
+				attributes.exclude_kernel = 1;
+				attributes.exclude_hv = 1;
+
+				descriptors[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+			}
+#endif
+		}
+
+		~HardwareCounters()
+		{
+#ifdef __linux__
+			for (int descriptor : descriptors)
+			{
+				if (descriptor >= 0) {
+					close(descriptor);
+				}
+			}
+#endif
+		}
+
+		bool IsAvailable() const
+		{
+			return descriptors[Cycles] >= 0 && descriptors[Instructions] >= 0 && descriptors[CacheMisses] >= 0;
+		}
+
+		void Start()
+		{
+#ifdef __linux__
+			for (int descriptor : descriptors)
+			{
+				if (descriptor >= 0)
+				{
+					ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+					ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+				}
+			}
+#endif
+		}
+
+		void Stop(std::uint64_t* values)
+		{
+			for (int i = 0; i < CounterCount; i++)
+			{
+				values[i] = 0;
+#ifdef __linux__
+				if (descriptors[i] >= 0)
+				{
+					ioctl(descriptors[i], PERF_EVENT_IOC_DISABLE, 0);
+
+					if (read(descriptors[i], &values[i], sizeof(values[i])) != sizeof(values[i])) {
+						values[i] = 0;
+					}
+				}
+#endif
+			}
+		}
+
+	private:
+		int descriptors[CounterCount] = { -1, -1, -1 };
+};
+
+struct PhaseResult
+{
+	std::string phase;
+	int size {0};
+	double nanosecondsPerCell {0.0};
+	double allocations {0.0};
+	std::uint64_t peakRssKilobytes {0};
+	bool hasBytes {false};
+	double bytesPerCell {0.0};
+	bool hasCounters {false};
+	double cyclesPerCell {0.0};
+	double instructionsPerCell {0.0};
+	double cacheMissesPerCell {0.0};
+};
+
+// A phase prepares its input for a seed outside of the measurement
+// and then runs the measured part.
+struct Phase
+{
+	const char* name;
+	std::function<void(int size, std::uint64_t seed)> prepare;
+	std::function<void()> run;
+	// Fails the run if the phase allocates at all.
+	bool allocationFree {false};
+	// The size of what the phase wrote, if it writes a file.
+	std::function<std::uint64_t()> bytes;
+	// Checks the output of a run, outside of the measurement.
+	std::function<bool()> check;
+};
+
+// Draws nothing; only makes the tile batch build its chunks.
+class NullTarget : public TileBatchTarget
+{
+	public:
+		virtual void DrawChunk(int, const TileChunk&) { }
+};
+
+static std::vector<std::uint64_t> ParseList(const char* text)
+{
+	std::vector<std::uint64_t> values;
+
+	while (*text)
+	{
+		char* end;
+		values.push_back(std::strtoull(text, &end, 10));
+		text = (*end == ',') ? end + 1 : end;
+
+		if (end == text && *end != '\0')
+			break;
+	}
+
+	return values;
+}
+
+static std::vector<std::string> ParseNames(const char* text)
+{
+	std::vector<std::string> names;
+	std::string name;
+
+	for (; ; text++)
+	{
+		if (*text == ',' || *text == '\0')
+		{
+			if (!name.empty()) {
+				names.push_back(name);
+			}
+
+			name.clear();
+
+			if (*text == '\0')
+				break;
+		}
+		else {
+			name += *text;
+		}
+	}
+
+	return names;
+}
+
+// Writes one result per line, which keeps the files easy to diff
+// and lets --compare read them back without a JSON library.
+static void WriteJson(std::FILE* file, const std::vector<PhaseResult>& results)
+{
+	std::fprintf(file, "{\n  \"results\": [\n");
+
+	for (std::size_t i = 0; i < results.size(); i++)
+	{
+		const PhaseResult& result = results[i];
+
+		std::fprintf(file, "    {\"phase\": \"%s\", \"size\": %d, \"nsPerCell\": %.4f, "
+		             "\"allocations\": %.1f, \"peakRssKb\": %llu",
+		             result.phase.c_str(), result.size, result.nanosecondsPerCell,
+		             result.allocations, static_cast<unsigned long long>(result.peakRssKilobytes));
+
+		if (result.hasBytes) {
+			std::fprintf(file, ", \"bytesPerCell\": %.4f", result.bytesPerCell);
+		}
+		else {
+			std::fprintf(file, ", \"bytesPerCell\": null");
+		}
+
+		if (result.hasCounters)
+		{
+			std::fprintf(file, ", \"cyclesPerCell\": %.4f, \"instructionsPerCell\": %.4f, "
+			             "\"cacheMissesPerCell\": %.6f", result.cyclesPerCell,
+			             result.instructionsPerCell, result.cacheMissesPerCell);
+		}
+		else {
+			std::fprintf(file, ", \"cyclesPerCell\": null, \"instructionsPerCell\": null, \"cacheMissesPerCell\": null");
+		}
+
+		std::fprintf(file, "}%s\n", (i + 1 < results.size()) ? "," : "");
+	}
+
+	std::fprintf(file, "  ]\n}\n");
+}
+
+static bool IsSameMaze(const Maze& maze, const Maze& other, bool compareSolution)
+{
+	if (maze.GetWidth() != other.GetWidth() || maze.GetHeight() != other.GetHeight() ||
+	    maze.GetSeed() != other.GetSeed() ||
+	    maze.GetStartPosition().x != other.GetStartPosition().x ||
+	    maze.GetStartPosition().y != other.GetStartPosition().y ||
+	    maze.GetExitPosition().x != other.GetExitPosition().x ||
+	    maze.GetExitPosition().y != other.GetExitPosition().y)
+		return false;
+
+	if (compareSolution && maze.GetSolution() != other.GetSolution())
+		return false;
+
+	for (int x = 0; x < maze.GetWidth(); x++)
+	{
+		for (int y = 0; y < maze.GetHeight(); y++)
+		{
+			if (maze.GetTiles()(x, y) != other.GetTiles()(x, y))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// FNV-1a over the tiles and the start and exit.
+static std::uint64_t HashMaze(const Maze& maze)
+{
+	std::uint64_t hash = 14695981039346656037ull;
+
+	auto add = [&hash](std::uint64_t value)
+	{
+		hash ^= value;
+		hash *= 1099511628211ull;
+	};
+
+	for (int x = 0; x < maze.GetWidth(); x++)
+	{
+		for (int y = 0; y < maze.GetHeight(); y++) {
+			add(static_cast<std::uint64_t>(maze.GetTiles()(x, y)));
+		}
+	}
+
+	add(static_cast<std::uint64_t>(maze.GetStartPosition().x));
+	add(static_cast<std::uint64_t>(maze.GetStartPosition().y));
+	add(static_cast<std::uint64_t>(maze.GetExitPosition().x));
+	add(static_cast<std::uint64_t>(maze.GetExitPosition().y));
+	return hash;
+}
+
+// Overwrites bytes of a file in place.
+static bool PatchFile(const char* path, long offset, const unsigned char* bytes, std::size_t count)
+{
+	std::FILE* file = std::fopen(path, "r+b");
+
+	if (file == nullptr)
+		return false;
+
+	bool patched = std::fseek(file, offset, SEEK_SET) == 0 && std::fwrite(bytes, 1, count, file) == count;
+	return std::fclose(file) == 0 && patched;
+}
+
+// Reads the phase, size and time per cell of every result line of a saved run.
+static bool ReadBaseline(const char* path, std::vector<PhaseResult>& baseline)
+{
+	std::FILE* file = std::fopen(path, "r");
+
+	if (file == nullptr)
+		return false;
+
+	char line[1024];
+
+	while (std::fgets(line, sizeof(line), file))
+	{
+		const char* phase = std::strstr(line, "\"phase\": \"");
+		const char* size = std::strstr(line, "\"size\": ");
+		const char* time = std::strstr(line, "\"nsPerCell\": ");
+
+		if (phase == nullptr || size == nullptr || time == nullptr)
+			continue;
+
+		PhaseResult result;
+		phase += std::strlen("\"phase\": \"");
+		result.phase.assign(phase, std::strchr(phase, '"'));
+		result.size = std::atoi(size + std::strlen("\"size\": "));
+		result.nanosecondsPerCell = std::atof(time + std::strlen("\"nsPerCell\": "));
+		baseline.push_back(result);
+	}
+
+	std::fclose(file);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<std::uint64_t> sizes = { 21, 101, 1001, 4001, 16001 };
+	std::vector<std::uint64_t> seeds = { 1, 2, 3 };
+	std::vector<std::string> phaseNames;
+	std::vector<std::uint64_t> threadCounts;
+	const char* output = nullptr;
+	const char* compare = nullptr;
+	double threshold = 10.0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+
+		if (std::strcmp(argv[i], "--sizes") == 0 && hasValue) {
+			sizes = ParseList(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--seeds") == 0 && hasValue) {
+			seeds = ParseList(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--phases") == 0 && hasValue) {
+			phaseNames = ParseNames(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--output") == 0 && hasValue) {
+			output = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--compare") == 0 && hasValue) {
+			compare = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue) {
+			threshold = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+			threadCounts = ParseList(argv[++i]);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: %s [--sizes 21,101,1001] [--seeds 1,2,3] [--phases a,b]\n"
+			                     "       [--output FILE] [--compare BASELINE] [--threshold PERCENT]\n"
+			                     "       [--threads 1,2,4,8]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	for (std::uint64_t size : sizes)
+	{
+		if (size % 2 == 0 || size < 5)
+		{
+			std::fprintf(stderr, "Sizes must be odd and at least 5.\n");
+			return 1;
+		}
+	}
+
+	if (seeds.empty())
+	{
+		std::fprintf(stderr, "At least one seed is needed.\n");
+		return 1;
+	}
+
+	// The names outlive the phases that point at them.
+	std::vector<std::string> sweepNames;
+
+	for (std::uint64_t threadCount : threadCounts)
+	{
+		if (threadCount < 1)
+		{
+			std::fprintf(stderr, "Thread counts must be at least 1.\n");
+			return 1;
+		}
+
+		sweepNames.push_back("generate-parallel-t" + std::to_string(threadCount));
+	}
+
+	if (std::find(phaseNames.begin(), phaseNames.end(), "generate-parallel") != phaseNames.end()) {
+		phaseNames.insert(phaseNames.end(), sweepNames.begin(), sweepNames.end());
+	}
+
+	MazeGenerator generator;
+	MazeSolver solver;
+	WallGeometry walls;
+	TileBatch tileBatch;
+	DistanceField distanceField;
+	IncrementalSolver incrementalSolver;
+	PathIndex pathIndex;
+	MazeRasterizer rasterizer;
+	PngEncoder pngEncoder;
+	std::unique_ptr<std::FILE, int (*)(std::FILE*)> imageFile(std::tmpfile(), &std::fclose);
+	std::vector<GridPosition> mutations;
+	const char* binaryPath = "MazeBenchmark.maze";
+	const char* textPath = "MazeBenchmark.txt";
+	MappedMaze mappedMaze;
+	std::unique_ptr<Maze> loadedMaze;
+	std::vector<char> textLines;
+	std::uint64_t fileBytes = 0;
+	Maze levelMaze { Matrix<TileType>(), GridPosition(), GridPosition() };
+	std::unique_ptr<Maze> maze;
+	int mazeSize = 0;
+	std::uint64_t mazeSeed = 0;
+
+	auto prepareMaze = [&](int size, std::uint64_t seed)
+	{
+		maze = generator.Create(size, size, seed);
+		mazeSize = size;
+		mazeSeed = seed;
+	};
+
+	// Walls between two cells of the lattice, so opening one makes a loop.
+	auto prepareMutations = [&](int size, std::uint64_t seed)
+	{
+		prepareMaze(size, seed);
+		incrementalSolver.Reset(*maze);
+		incrementalSolver.Solve();
+
+		RandomEngine random(seed);
+		mutations.clear();
+
+		while (mutations.size() < 64)
+		{
+			int x = 1 + static_cast<int>(RandomBelow(random, size - 2));
+			int y = 1 + static_cast<int>(RandomBelow(random, size - 2));
+
+			if ((x + y) % 2 == 1 && maze->HasTileAt(x, y, TileType::Wall)) {
+				mutations.push_back({ x, y });
+			}
+		}
+	};
+
+	auto mutatePhase = [&](const char* name, bool incremental) -> Phase
+	{
+		return { name, prepareMutations, [&, incremental]()
+		{
+			solver.SetAlgorithm(SolverAlgorithm::BreadthFirst);
+
+			for (GridPosition position : mutations)
+			{
+				for (int change = 0; change < 2; change++)
+				{
+					if (change == 0) {
+						maze->OpenCell(position);
+					}
+					else {
+						maze->CloseCell(position);
+					}
+
+					if (incremental)
+					{
+						incrementalSolver.NotifyChanged(position);
+						incrementalSolver.Solve();
+					}
+					else {
+						solver.Solve(*maze);
+					}
+				}
+			}
+		} };
+	};
+
+	// The work of a new level on the game thread and the level loader,
+	// minus the window: the maze is generated into the previous one,
+	// solved, and the tiles around the start are built and colored.
+	// Playing a level moves the view over all of it, which the warm-up
+	// level does as well.
+	auto runLevel = [&](std::uint64_t seed, bool play)
+	{
+		const float tileSize = 32.0f;
+		NullTarget target;
+
+		generator.Create(mazeSize, mazeSize, seed, levelMaze);
+		levelMaze.Solve();
+		tileBatch.Build(levelMaze.GetTiles(), tileSize, TileColor(), TileColor(), 256);
+
+		TileColor solutionColor;
+		solutionColor.r = 255;
+
+		for (std::uint32_t index : levelMaze.GetSolution())
+		{
+			GridPosition position = levelMaze.GetPosition(index);
+			tileBatch.SetColor(position.x, position.y, solutionColor);
+		}
+
+		ViewRect view;
+		view.width = 1280.0f;
+		view.height = 720.0f;
+		view.left = levelMaze.GetStartPosition().x * tileSize - view.width * 0.5f;
+		view.top = levelMaze.GetStartPosition().y * tileSize - view.height * 0.5f;
+		tileBatch.Draw(view, target);
+
+		for (view.top = 0.0f; play && view.top < mazeSize * tileSize; view.top += view.height)
+		{
+			for (view.left = 0.0f; view.left < mazeSize * tileSize; view.left += view.width) {
+				tileBatch.Draw(view, target);
+			}
+		}
+	};
+
+	auto prepareFile = [&](int size, std::uint64_t seed)
+	{
+		prepareMaze(size, seed);
+		maze->Solve();
+		mappedMaze.Close();
+		loadedMaze.reset();
+		fileBytes = 0;
+	};
+
+	// The mapped file must hold the maze and its solution, and must
+	// notice a flipped bit and a start outside the grid.
+	auto checkBinaryFile = [&]() -> bool
+	{
+		if (!mappedMaze.IsOpen() || !mappedMaze.VerifyChecksum() || !IsSameMaze(*maze, *mappedMaze.ToMaze(), true))
+			return false;
+
+		mappedMaze.Close();
+
+		unsigned char flipped = 0x01;
+		unsigned char original = 0x00;
+		std::FILE* file = std::fopen(binaryPath, "rb");
+
+		if (file == nullptr || std::fseek(file, MazeFile::headerSize, SEEK_SET) != 0 || std::fread(&original, 1, 1, file) != 1)
+		{
+			if (file != nullptr) {
+				std::fclose(file);
+			}
+
+			return false;
+		}
+
+		std::fclose(file);
+		flipped ^= original;
+
+		if (!PatchFile(binaryPath, MazeFile::headerSize, &flipped, 1) || !mappedMaze.Open(binaryPath) || mappedMaze.VerifyChecksum())
+			return false;
+
+		mappedMaze.Close();
+
+		// The start x, stored little-endian at byte 24.
+		std::uint32_t width = static_cast<std::uint32_t>(maze->GetWidth());
+		unsigned char startX[4] = {
+			static_cast<unsigned char>(width), static_cast<unsigned char>(width >> 8),
+			static_cast<unsigned char>(width >> 16), static_cast<unsigned char>(width >> 24)
+		};
+
+		return PatchFile(binaryPath, 24, startX, sizeof(startX)) && !mappedMaze.Open(binaryPath);
+	};
+
+	// The hash of every maze of the sweep, by size and seed, from the
+	// first thread count that made it.
+	std::map<std::pair<int, std::uint64_t>, std::uint64_t> sweepHashes;
+
+	auto sweepPhase = [&](const std::string& name, int threadCount) -> Phase
+	{
+		return { name.c_str(), [&](int size, std::uint64_t seed) { maze.reset(); mazeSize = size; mazeSeed = seed; },
+		         [&, threadCount]() { maze = generator.CreateParallel(mazeSize, mazeSize, mazeSeed, threadCount); },
+		         false, nullptr, [&]()
+		         {
+			         std::uint64_t hash = HashMaze(*maze);
+			         return sweepHashes.emplace(std::make_pair(mazeSize, mazeSeed), hash).first->second == hash;
+		         } };
+	};
+
+	auto solvePhase = [&](const char* name, SolverAlgorithm algorithm) -> Phase
+	{
+		return { name, [&, algorithm](int size, std::uint64_t seed)
+		{
+			prepareMaze(size, seed);
+			solver.SetAlgorithm(algorithm);
+		}, [&]() { solver.Solve(*maze); } };
+	};
+
+	std::vector<Phase> phases = {
+		{ "generate", [&](int size, std::uint64_t seed) { maze.reset(); mazeSize = size; mazeSeed = seed; },
+		  [&]() { maze = generator.Create(mazeSize, mazeSize, mazeSeed); } },
+		{ "generate-parallel", [&](int size, std::uint64_t seed) { maze.reset(); mazeSize = size; mazeSeed = seed; },
+		  [&]() { maze = generator.CreateParallel(mazeSize, mazeSize, mazeSeed); } },
+		{ "walls", prepareMaze, [&]() { walls.Build(maze->GetTiles()); } },
+		// Sweeps a view over the whole grid, so that every chunk is
+		// built once while the cache stays at its usual size.
+		{ "tiles", prepareMaze, [&]()
+		  {
+			  const float tileSize = 32.0f;
+			  const float viewSize = TileBatch::chunkTiles * tileSize;
+			  float extent = mazeSize * tileSize;
+			  NullTarget target;
+
+			  tileBatch.Build(maze->GetTiles(), tileSize, TileColor(), TileColor(), 256);
+
+			  for (float top = 0.0f; top < extent; top += viewSize)
+			  {
+				  for (float left = 0.0f; left < extent; left += viewSize)
+				  {
+					  ViewRect view;
+					  view.left = left;
+					  view.top = top;
+					  view.width = viewSize * 0.5f;
+					  view.height = viewSize * 0.5f;
+					  tileBatch.Draw(view, target);
+				  }
+			  }
+		  } },
+		solvePhase("solve-walker", SolverAlgorithm::Walker),
+		solvePhase("solve-bfs", SolverAlgorithm::BreadthFirst),
+		solvePhase("solve-astar", SolverAlgorithm::AStar),
+		solvePhase("solve-deadend", SolverAlgorithm::DeadEndFilling),
+		{ "distance-field", prepareMaze, [&]() { distanceField.Build(*maze); } },
+		{ "path-index", prepareMaze, [&]() { pathIndex.Build(*maze); } },
+		// Two pixels per cell, written over the same temporary file.
+		{ "image-png", [&](int size, std::uint64_t seed)
+		  {
+			  prepareMaze(size, seed);
+			  maze->Solve();
+
+			  if (imageFile) {
+				  std::rewind(imageFile.get());
+			  }
+		  },
+		  [&]()
+		  {
+			  RasterSettings settings;
+			  settings.pixelsPerCell = 2;
+
+			  if (imageFile) {
+				  rasterizer.Write(*maze, settings, pngEncoder, imageFile.get());
+			  }
+		  } },
+		// A warm-up level with another seed comes first; the level after
+		// it must not allocate.
+		{ "level-reuse", [&](int size, std::uint64_t seed)
+		  {
+			  mazeSize = size;
+			  mazeSeed = seed;
+			  runLevel(~seed, true);
+		  },
+		  [&]() { runLevel(mazeSeed, false); }, true },
+		mutatePhase("mutate-incremental", true),
+		mutatePhase("mutate-resolve", false),
+		// Writes the solved maze and maps it back, which reads only the header.
+		{ "file", prepareFile, [&]()
+		  {
+			  MazeFile::Write(*maze, binaryPath);
+			  mappedMaze.Open(binaryPath);
+			  fileBytes = MazeFile::GetFileSize(*maze);
+		  }, false, [&]() { return fileBytes; }, checkBinaryFile },
+		// The same round trip through the text dump, which has to be parsed.
+		{ "file-text", prepareFile, [&]()
+		  {
+			  std::FILE* file = std::fopen(textPath, "w+b");
+
+			  if (file == nullptr)
+				  return;
+
+			  MazeFile::WriteText(*maze, file, textLines);
+			  fileBytes = static_cast<std::uint64_t>(std::ftell(file));
+			  std::rewind(file);
+			  loadedMaze = MazeFile::ReadText(file);
+			  std::fclose(file);
+		  }, false, [&]() { return fileBytes; },
+		  [&]() { return loadedMaze != nullptr && IsSameMaze(*maze, *loadedMaze, false); } }
+	};
+
+	// The sweep takes the place of the run with the default thread count.
+	if (!sweepNames.empty())
+	{
+		auto parallel = std::find_if(phases.begin(), phases.end(),
+		                             [](const Phase& phase) { return std::strcmp(phase.name, "generate-parallel") == 0; });
+		parallel = phases.erase(parallel);
+
+		for (std::size_t i = 0; i < sweepNames.size(); i++) {
+			parallel = phases.insert(parallel, sweepPhase(sweepNames[i], static_cast<int>(threadCounts[i]))) + 1;
+		}
+	}
+
+	HardwareCounters counters;
+	std::vector<PhaseResult> results;
+	int allocationFailures = 0;
+	int checkFailures = 0;
+
+	for (const Phase& phase : phases)
+	{
+		if (!phaseNames.empty() && std::find(phaseNames.begin(), phaseNames.end(), phase.name) == phaseNames.end())
+			continue;
+
+		for (std::uint64_t size : sizes)
+		{
+			double cells = static_cast<double>(size) * size;
+			std::vector<double> times;
+			std::uint64_t allocations = 0;
+			std::uint64_t bytes = 0;
+			bool checked = true;
+			std::uint64_t totals[HardwareCounters::CounterCount] = {};
+
+			for (std::uint64_t seed : seeds)
+			{
+				phase.prepare(static_cast<int>(size), seed);
+
+				std::uint64_t values[HardwareCounters::CounterCount];
+				std::uint64_t allocationsBefore = allocationCount.load();
+				counters.Start();
+				auto begin = std::chrono::steady_clock::now();
+
+				phase.run();
+
+				auto end = std::chrono::steady_clock::now();
+				counters.Stop(values);
+				allocations += allocationCount.load() - allocationsBefore;
+
+				times.push_back(std::chrono::duration<double, std::nano>(end - begin).count() / cells);
+
+				for (int i = 0; i < HardwareCounters::CounterCount; i++) {
+					totals[i] += values[i];
+				}
+
+				if (phase.bytes) {
+					bytes += phase.bytes();
+				}
+
+				if (phase.check && !phase.check()) {
+					checked = false;
+				}
+			}
+
+			std::sort(times.begin(), times.end());
+
+			PhaseResult result;
+			result.phase = phase.name;
+			result.size = static_cast<int>(size);
+			result.nanosecondsPerCell = times[times.size() / 2];
+			result.allocations = static_cast<double>(allocations) / seeds.size();
+			result.peakRssKilobytes = GetPeakRssKilobytes();
+			result.hasBytes = static_cast<bool>(phase.bytes);
+			result.bytesPerCell = bytes / (cells * seeds.size());
+			result.hasCounters = counters.IsAvailable();
+			result.cyclesPerCell = totals[HardwareCounters::Cycles] / (cells * seeds.size());
+			result.instructionsPerCell = totals[HardwareCounters::Instructions] / (cells * seeds.size());
+			result.cacheMissesPerCell = totals[HardwareCounters::CacheMisses] / (cells * seeds.size());
+			results.push_back(result);
+
+			std::fprintf(stderr, "%-22s %6d %10.3f ns/cell %10.1f allocations\n",
+			             phase.name, result.size, result.nanosecondsPerCell, result.allocations);
+
+			if (phase.allocationFree && allocations > 0)
+			{
+				std::fprintf(stderr, "ALLOCATION %s %d: expected none\n", phase.name, result.size);
+				allocationFailures++;
+			}
+
+			if (result.hasBytes) {
+				std::fprintf(stderr, "%-22s %6d %10.3f B/cell\n", phase.name, result.size, result.bytesPerCell);
+			}
+
+			if (!checked)
+			{
+				std::fprintf(stderr, "CHECK %s %d: the maze is not the one expected\n", phase.name, result.size);
+				checkFailures++;
+			}
+		}
+
+		// Keeps the peak resident set of one phase from hiding the next.
+		maze.reset();
+		loadedMaze.reset();
+	}
+
+	mappedMaze.Close();
+	std::remove(binaryPath);
+	std::remove(textPath);
+
+	int failureCode = allocationFailures > 0 ? 3 : checkFailures > 0 ? 4 : 0;
+
+	std::FILE* file = (output == nullptr) ? stdout : std::fopen(output, "w");
+
+	if (file == nullptr)
+	{
+		std::fprintf(stderr, "Cannot open %s\n", output);
+		return 1;
+	}
+
+	WriteJson(file, results);
+
+	if (file != stdout) {
+		std::fclose(file);
+	}
+
+	if (compare == nullptr)
+		return failureCode;
+
+	std::vector<PhaseResult> baseline;
+
+	if (!ReadBaseline(compare, baseline))
+	{
+		std::fprintf(stderr, "Cannot read %s\n", compare);
+		return 1;
+	}
+
+	int regressions = 0;
+
+	for (const PhaseResult& result : results)
+	{
+		for (const PhaseResult& saved : baseline)
+		{
+			if (saved.phase != result.phase || saved.size != result.size || saved.nanosecondsPerCell <= 0.0)
+				continue;
+
+			double change = 100.0 * (result.nanosecondsPerCell / saved.nanosecondsPerCell - 1.0);
+
+			if (change > threshold)
+			{
+				std::fprintf(stderr, "REGRESSION %s %d: %.3f -> %.3f ns/cell (+%.1f%%)\n",
+				             result.phase.c_str(), result.size, saved.nanosecondsPerCell,
+				             result.nanosecondsPerCell, change);
+				regressions++;
+			}
+		}
+	}
+
+	std::fprintf(stderr, "%d regression(s) beyond %.1f%%\n", regressions, threshold);
+	return regressions > 0 ? 2 : failureCode;
+}
@@ -0,0 +1,140 @@
+// Measures how fast the path index answers distance queries between
+// random cells of a maze.
+//
+// Usage: PathQueryBenchmark [--size 2001] [--queries 1000000,10000000]
+//                           [--threads N]
+//
+// Reports the time to build the index and its size, then answers each
+// batch of random queries serially and on a pool of threads. Before
+// that, distances to the exit are checked against a distance field
+// and path lengths against distances.
+#include "MazeGenerator.h"
+#include "DistanceField.h"
+#include "PathIndex.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static std::vector<std::uint64_t> ParseList(const char* text)
+{
+	std::vector<std::uint64_t> values;
+
+	while (*text)
+	{
+		char* end;
+		values.push_back(std::strtoull(text, &end, 10));
+		text = (*end == ',') ? end + 1 : end;
+
+		if (end == text && *end != '\0')
+			break;
+	}
+
+	return values;
+}
+
+static double Measure(const PathIndex& index, const std::vector<PathQuery>& queries,
+                      std::vector<std::uint32_t>& distances, WorkStealingPool* pool)
+{
+	auto begin = std::chrono::steady_clock::now();
+	index.GetDistances(queries, distances, pool);
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+int main(int argc, char** argv)
+{
+	int size = 2001;
+	std::vector<std::uint64_t> queryCounts = { 1000000, 10000000 };
+	int threadCount = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+
+		if (std::strcmp(argv[i], "--size") == 0 && hasValue) {
+			size = std::atoi(argv[++i]) | 1;
+		}
+		else if (std::strcmp(argv[i], "--queries") == 0 && hasValue) {
+			queryCounts = ParseList(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue) {
+			threadCount = std::atoi(argv[++i]);
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: %s [--size N] [--queries 1000000,10000000] [--threads N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	MazeGenerator generator;
+	std::unique_ptr<Maze> maze = generator.Create(size, size, 42);
+
+	PathIndex index;
+	auto begin = std::chrono::steady_clock::now();
+	index.Build(*maze);
+	double buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+	std::printf("maze %dx%d, index of %zu cells built in %.2f ms (%.2f ns/cell), %.1f MB\n", size, size,
+	            index.GetTreeSize(), buildSeconds * 1e3, buildSeconds * 1e9 / index.GetTreeSize(),
+	            index.GetMemoryBytes() / (1024.0 * 1024.0));
+
+	// Random open cells, so that every query has an answer.
+	RandomEngine random(7);
+	std::vector<std::uint32_t> openCells;
+
+	for (std::uint32_t cell = 0; cell < static_cast<std::uint32_t>(size) * size; cell++)
+	{
+		GridPosition position = maze->GetPosition(cell);
+
+		if (!maze->HasTileAt(position.x, position.y, TileType::Wall)) {
+			openCells.push_back(cell);
+		}
+	}
+
+	DistanceField field;
+	field.Build(*maze);
+
+	std::uint32_t exit = maze->GetIndex(maze->GetExitPosition());
+	std::vector<std::uint32_t> path;
+	int mismatches = 0;
+
+	for (int check = 0; check < 1000; check++)
+	{
+		std::uint32_t from = openCells[RandomBelow(random, openCells.size())];
+		std::uint32_t to = openCells[RandomBelow(random, openCells.size())];
+		index.GetPath(from, to, path);
+
+		if (index.GetDistance(from, exit) != field.GetDistance(from) ||
+		    path.size() != index.GetDistance(from, to) + 1 || path.front() != from || path.back() != to)
+			mismatches++;
+	}
+
+	std::printf("%d mismatches in 1000 checks\n", mismatches);
+
+	WorkStealingPool pool(threadCount);
+	std::printf("%12s %22s %22s (%d threads)\n", "queries", "serial queries/s", "pool queries/s", pool.GetThreadCount());
+
+	std::vector<PathQuery> queries;
+	std::vector<std::uint32_t> distances;
+
+	for (std::uint64_t queryCount : queryCounts)
+	{
+		queries.resize(queryCount);
+
+		for (PathQuery& query : queries)
+		{
+			query.from = openCells[RandomBelow(random, openCells.size())];
+			query.to = openCells[RandomBelow(random, openCells.size())];
+		}
+
+		double serialSeconds = Measure(index, queries, distances, nullptr);
+		double poolSeconds = Measure(index, queries, distances, &pool);
+
+		std::printf("%12llu %22.3e %22.3e\n", static_cast<unsigned long long>(queryCount),
+		            queryCount / serialSeconds, queryCount / poolSeconds);
+	}
+
+	return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+// Measures the CPU cost of drawing a maze without a window.
+//
+// Usage: RenderBenchmark [--sizes 1001,4001,8001] [--view 1280x720]
+//                        [--tile 32] [--frames 2000] [--idle 2]
+//
+// A camera walks along the solution of each maze, one tile per step,
+// and every step is followed by idle frames in which nothing changes,
+// as when frames are drawn faster than the simulation steps. Each frame
+// is drawn in two ways into a target that converts the chunks the way
+// the SFML view does and counts the submissions and drawn vertices:
+// "full" draws the chunks within the view every frame, "layer" draws
+// only what LayerCache asks to redraw into a cached layer, plus the
+// layer itself. Results per size and mode go to stdout.
+#include "MazeGenerator.h"
+#include "TileBatch.h"
+#include "LayerCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Stands in for sf::Vertex, so that copying costs the same.
+struct RecordedVertex
+{
+	float x;
+	float y;
+	TileColor color;
+	float u;
+	float v;
+};
+
+class RecordingTarget : public TileBatchTarget
+{
+	public:
+		std::uint64_t submissions {0};
+		std::uint64_t uploadedVertices {0};
+		std::uint64_t drawnVertices {0};
+
+		virtual void DrawChunk(int slot, const TileChunk& chunk)
+		{
+			if (slot >= static_cast<int>(slots.size())) {
+				slots.resize(slot + 1);
+			}
+
+			std::vector<RecordedVertex>& vertices = slots[slot];
+			std::size_t first = chunk.firstChanged;
+			std::size_t end = chunk.endChanged;
+
+			if (chunk.rebuilt)
+			{
+				vertices.resize(chunk.quads.size() + chunk.lines.size());
+				first = 0;
+				end = vertices.size();
+			}
+
+			for (std::size_t i = first; i < end; i++)
+			{
+				const TileVertex& vertex = (i < chunk.quads.size()) ? chunk.quads[i] 
+					                                            : chunk.lines[i - chunk.quads.size()];
+				vertices[i] = { vertex.x, vertex.y, vertex.color, 0.0f, 0.0f };
+			}
+
+			uploadedVertices += end - first;
+			Submit(vertices.data(), vertices.size());
+			submissions += 2;
+		}
+
+		// SFML hands the vertices of every draw call to the driver, which
+		// copies them; the copy stands in for that.
+		void Submit(const RecordedVertex* vertices, std::size_t count)
+		{
+			submitted.assign(vertices, vertices + count);
+			drawnVertices += count;
+		}
+
+	private:
+		std::vector<std::vector<RecordedVertex>> slots;
+		std::vector<RecordedVertex> submitted;
+};
+
+static std::vector<int> ParseSizes(const char* text)
+{
+	std::vector<int> sizes;
+
+	while (*text)
+	{
+		char* end;
+		sizes.push_back(static_cast<int>(std::strtol(text, &end, 10)));
+		text = (*end == ',') ? end + 1 : end;
+
+		if (end == text && *end != '\0')
+			break;
+	}
+
+	return sizes;
+}
+
+struct FrameCosts
+{
+	double nanosecondsPerStep {0.0};
+	double nanosecondsPerIdle {0.0};
+	double submissionsPerFrame {0.0};
+	double verticesPerFrame {0.0};
+};
+
+static FrameCosts Run(const Maze& maze, float tileSize, int viewWidth, int viewHeight, 
+                      int frames, int idleFrames, bool layered)
+{
+	const std::vector<std::uint32_t>& solution = maze.GetSolution();
+
+	TileBatch batch;
+	batch.Build(maze.GetTiles(), tileSize, { 255, 255, 255, 255 }, { 0, 255, 0, 255 }, 256);
+
+	for (std::uint32_t index : solution)
+	{
+		GridPosition position = maze.GetPosition(index);
+		batch.SetColor(position.x, position.y, { 255, 0, 0, 255 });
+	}
+
+	LayerCache layer;
+	layer.Reset(viewWidth * 2.0f, viewHeight * 2.0f);
+
+	RecordingTarget target;
+	std::chrono::nanoseconds stepTime(0);
+	std::chrono::nanoseconds idleTime(0);
+	int steps = 0;
+
+	for (int frame = 0; frame < frames; frame++)
+	{
+		bool step = (frame % (idleFrames + 1) == 0);
+		steps += step;
+
+		// The camera moves one tile per step along the solution.
+		GridPosition position = maze.GetPosition(solution[(steps - 1) % solution.size()]);
+
+		ViewRect view;
+		view.left = position.x * tileSize - viewWidth * 0.5f;
+		view.top = position.y * tileSize - viewHeight * 0.5f;
+		view.width = static_cast<float>(viewWidth);
+		view.height = static_cast<float>(viewHeight);
+
+		auto begin = std::chrono::steady_clock::now();
+
+		if (step)
+		{
+			batch.SetColor(position.x, position.y, { 0, 0, 0, 255 });
+
+			// The tile, grown by half the width of the walls.
+			layer.MarkDirty({ position.x * tileSize - 2.0f, position.y * tileSize - 2.0f,
+			                  tileSize + 4.0f, tileSize + 4.0f });
+		}
+
+		if (layered)
+		{
+			for (const ViewRect& region : layer.Update(view)) {
+				batch.Draw(region, target);
+			}
+
+			// The layer is drawn as one quad.
+			RecordedVertex quad[4] = {};
+			target.Submit(quad, 4);
+			target.submissions++;
+		}
+		else
+		{
+			batch.Draw(view, target);
+		}
+
+		(step ? stepTime : idleTime) += std::chrono::steady_clock::now() - begin;
+	}
+
+	int idle = frames - steps;
+
+	FrameCosts costs;
+	costs.nanosecondsPerStep = static_cast<double>(stepTime.count()) / std::max(1, steps);
+	costs.nanosecondsPerIdle = static_cast<double>(idleTime.count()) / std::max(1, idle);
+	costs.submissionsPerFrame = static_cast<double>(target.submissions) / frames;
+	costs.verticesPerFrame = static_cast<double>(target.drawnVertices) / frames;
+	return costs;
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<int> sizes = { 1001, 4001, 8001 };
+	int viewWidth = 1280;
+	int viewHeight = 720;
+	float tileSize = 32.0f;
+	int frames = 2000;
+	int idleFrames = 2;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+
+		if (std::strcmp(argv[i], "--sizes") == 0 && hasValue) {
+			sizes = ParseSizes(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--view") == 0 && hasValue) {
+			std::sscanf(argv[++i], "%dx%d", &viewWidth, &viewHeight);
+		}
+		else if (std::strcmp(argv[i], "--tile") == 0 && hasValue) {
+			tileSize = static_cast<float>(std::atof(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--frames") == 0 && hasValue) {
+			frames = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--idle") == 0 && hasValue) {
+			idleFrames = std::max(0, std::atoi(argv[++i]));
+		}
+		else
+		{
+			std::fprintf(stderr, "Usage: %s [--sizes 1001,4001] [--view WxH] [--tile PIXELS] [--frames N] [--idle N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	MazeGenerator generator;
+	std::printf(" size  mode   ns/step  ns/idle  submissions/frame  vertices/frame\n");
+
+	for (int size : sizes)
+	{
+		std::unique_ptr<Maze> maze = generator.Create(size, size, 42);
+		maze->Solve();
+
+		for (bool layered : { false, true })
+		{
+			FrameCosts costs = Run(*maze, tileSize, viewWidth, viewHeight, frames, idleFrames, layered);
+
+			std::printf("%5d  %-5s %8.0f %8.0f %18.1f %15.0f\n", size, layered ? "layer" : "full",
+			            costs.nanosecondsPerStep, costs.nanosecondsPerIdle, 
+			            costs.submissionsPerFrame, costs.verticesPerFrame);
+		}
+	}
+
+	return 0;
+}